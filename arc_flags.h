@@ -0,0 +1,370 @@
+#ifndef HOMEWORK_GRAPH_ARC_FLAGS_H
+#define HOMEWORK_GRAPH_ARC_FLAGS_H
+
+
+#include "graph.h"
+#include "search_engine.h"
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+
+// Arco invertido (from -> v) usado por las busquedas hacia atras del preprocesamiento
+struct ReverseArc {
+    std::uint32_t from;
+    double length;
+    std::uint32_t slot;
+};
+
+
+// *
+// ---- ReverseTopology ----
+// Grafo invertido con indices densos: for_each_edge(v) recorre los arcos que llegan a 'v'.
+// *
+struct ReverseTopology {
+    using node_type = std::uint32_t;
+    using edge_type = ReverseArc;
+
+    template <typename T>
+    using node_map = DenseNodeMap<T>;
+
+    const std::vector<std::uint32_t> *offsets = nullptr;
+    const std::vector<ReverseArc> *arcs = nullptr;
+
+    template <typename Visit>
+    void for_each_edge(std::uint32_t v, Visit &&visit) const {
+        for (std::uint32_t k = (*offsets)[v]; k < (*offsets)[v + 1]; ++k) {
+            visit((*arcs)[k], (*arcs)[k].from);
+        }
+    }
+};
+
+
+// *
+// ---- ArcFlags ----
+// Aceleracion goal-directed para Dijkstra. El grafo se parte en 'cells' celdas por biseccion recursiva de
+// coordenadas y cada arco (una entrada de 'Node::edges', en el sentido en que se recorre) guarda un bit por celda:
+// el bit de la celda c esta prendido si el arco esta en algun camino mas corto hacia un vertice de c.
+//
+// Preprocesamiento, en paralelo por celda:
+//     - Los arcos con ambos extremos en c llevan el bit de c.
+//     - Desde cada vertice frontera b de c (vertice de c con un arco entrante desde otra celda) se corre un Dijkstra
+//       hacia atras; todo arco (u, v) con dist(u, b) == length + dist(v, b) lleva el bit de c.
+//
+// En la consulta se corre Dijkstra normal sobre 'Node::edges' saltando los arcos cuyo bit de la celda de 'dest'
+// esta apagado ('ArcFlagTopology'), asi la visualizacion paso a paso sigue teniendo sentido.
+//
+// Variables miembro
+//     - cells         : Cantidad de celdas
+//     - cell          : Celda de cada vertice (indice denso)
+//     - index         : Indice denso de cada 'Node*'
+//     - first_arc     : Slot del primer arco de cada vertice; el arco k de 'u->edges' es first_arc[u] + k
+//     - flags         : Arreglo de bits empaquetado, 'cells' bits por arco: el bit de la celda c del arco 'slot' es
+//                       el bit slot * cells + c (asi con 32 celdas se usa la mitad que con 64, sin relleno)
+//
+// Funciones miembro
+//     - has_flag      : Si el arco 'slot' sirve para llegar a la celda 'target_cell'
+//     - cell_of       : Celda de un vertice
+//     - compare       : Corre consultas aleatorias con y sin arc flags y mide la reduccion de vertices asentados
+// *
+class ArcFlags {
+public:
+    //* --- Report ---
+    //     - boundary_nodes    : Vertices frontera (una busqueda hacia atras por cada uno)
+    //     - preprocessing_ms  : Tiempo de particion + busquedas hacia atras
+    //     - flag_bytes        : Memoria de los bits por arco
+    //     - flag_density      : Fraccion de bits prendidos
+    //*
+    struct Report {
+        std::size_t cells = 0;
+        std::size_t arcs = 0;
+        std::size_t boundary_nodes = 0;
+        unsigned threads = 1;
+        double preprocessing_ms = 0.0;
+        std::size_t flag_bytes = 0;
+        double flag_density = 0.0;
+    };
+
+    //* --- QueryReport ---
+    //     - dijkstra_settled  : Vertices asentados por 'DijkstraSearch' (lo mismo que 'dijkstra()' sin dibujar)
+    //     - arc_flags_settled : Vertices asentados usando arc flags
+    //     - mismatches        : Consultas cuya distancia no coincide (deberia ser 0)
+    //*
+    struct QueryReport {
+        std::size_t queries = 0;
+        std::size_t dijkstra_settled = 0;
+        std::size_t arc_flags_settled = 0;
+        double dijkstra_ms = 0.0;
+        double arc_flags_ms = 0.0;
+        std::size_t mismatches = 0;
+
+        double reduction() const {
+            return static_cast<double>(dijkstra_settled) / static_cast<double>(std::max<std::size_t>(1, arc_flags_settled));
+        }
+    };
+
+    std::size_t cells;
+    std::vector<std::uint32_t> cell;
+    std::unordered_map<Node *, std::uint32_t> index;
+    std::vector<std::uint32_t> first_arc;
+    std::vector<std::uint64_t> flags;
+    Report report;
+
+    explicit ArcFlags(Graph &graph, std::size_t cells = 32, unsigned threads = 0)
+            : cells(std::max<std::size_t>(1, cells)) {
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+        threads = (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+        std::vector<Node *> nodes;
+        nodes.reserve(graph.nodes.size());
+        for (auto &[_, node] : graph.nodes) {
+            index[node] = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back(node);
+        }
+        partition(nodes);
+
+        // Slots de arcos en el orden de 'Node::edges' y el grafo invertido para las busquedas hacia atras
+        std::vector<std::uint32_t> heads;
+        std::vector<double> lengths;
+        first_arc.reserve(nodes.size() + 1);
+        for (Node *u : nodes) {
+            first_arc.push_back(static_cast<std::uint32_t>(heads.size()));
+            PointerTopology().for_each_edge(u, [&](const Edge &e, Node *v) {
+                heads.push_back(index[v]);
+                lengths.push_back(e.length);
+            });
+        }
+        first_arc.push_back(static_cast<std::uint32_t>(heads.size()));
+        std::size_t arcs = heads.size();
+
+        std::vector<std::uint32_t> reverse_offsets(nodes.size() + 1, 0);
+        for (std::uint32_t v : heads) ++reverse_offsets[v + 1];
+        for (std::size_t v = 0; v < nodes.size(); ++v) reverse_offsets[v + 1] += reverse_offsets[v];
+        std::vector<ReverseArc> reverse(arcs);
+        std::vector<std::uint32_t> fill(reverse_offsets.begin(), reverse_offsets.end() - 1);
+        for (std::uint32_t u = 0; u < nodes.size(); ++u) {
+            for (std::uint32_t slot = first_arc[u]; slot < first_arc[u + 1]; ++slot) {
+                reverse[fill[heads[slot]]++] = {u, lengths[slot], slot};
+            }
+        }
+
+        // Vertices frontera de cada celda
+        std::vector<std::vector<std::uint32_t>> boundary(this->cells);
+        for (std::uint32_t v = 0; v < nodes.size(); ++v) {
+            for (std::uint32_t k = reverse_offsets[v]; k < reverse_offsets[v + 1]; ++k) {
+                if (cell[reverse[k].from] != cell[v]) {
+                    boundary[cell[v]].push_back(v);
+                    break;
+                }
+            }
+        }
+
+        std::size_t words = (arcs * this->cells + 63) / 64;
+        std::vector<std::atomic<std::uint64_t>> shared(words);
+        for (auto &word : shared) word.store(0, std::memory_order_relaxed);
+
+        std::atomic<std::size_t> next_cell{0};
+        auto worker = [&] {
+            std::vector<char> marked(arcs);
+            ReverseTopology topology{&reverse_offsets, &reverse};
+            for (std::size_t c = next_cell++; c < this->cells; c = next_cell++) {
+                std::fill(marked.begin(), marked.end(), 0);
+                for (std::uint32_t u = 0; u < nodes.size(); ++u) {
+                    if (cell[u] != c) continue;
+                    for (std::uint32_t slot = first_arc[u]; slot < first_arc[u + 1]; ++slot) {
+                        if (cell[heads[slot]] == c) marked[slot] = 1;
+                    }
+                }
+
+                for (std::uint32_t b : boundary[c]) {
+                    SearchEngine<LengthWeight, ZeroHeuristic, MinHeapQueue, ExhaustiveSearch, NullVisitor,
+                                 ReverseTopology> backward(NullVisitor(), LengthWeight(), ZeroHeuristic(),
+                                                           ExhaustiveSearch(), topology);
+                    auto result = backward.run(b, b);
+
+                    // Arcos tensos: (u, v) esta en un camino mas corto de u hacia b
+                    for (std::uint32_t v = 0; v < result.dist.capacity(); ++v) {
+                        auto to_v = result.dist.find(v);
+                        if (to_v == result.dist.end()) continue;
+                        topology.for_each_edge(v, [&](const ReverseArc &arc, std::uint32_t u) {
+                            auto to_u = result.dist.find(u);
+                            if (to_u == result.dist.end()) return;
+                            double through = to_v->second + arc.length;
+                            if (through <= to_u->second + 1e-9 * std::max(1.0, to_u->second)) marked[arc.slot] = 1;
+                        });
+                    }
+                }
+
+                // Arcos vecinos comparten palabra, por eso el 'fetch_or' aunque cada hilo tenga celdas distintas
+                for (std::size_t slot = 0; slot < arcs; ++slot) {
+                    if (!marked[slot]) continue;
+                    std::size_t bit = slot * this->cells + c;
+                    shared[bit / 64].fetch_or(std::uint64_t{1} << (bit % 64), std::memory_order_relaxed);
+                }
+            }
+        };
+
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, this->cells));
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+        worker();
+        for (std::thread &thread : pool) thread.join();
+
+        flags.resize(words);
+        std::size_t set = 0;
+        for (std::size_t k = 0; k < flags.size(); ++k) {
+            flags[k] = shared[k].load(std::memory_order_relaxed);
+            set += popcount(flags[k]);
+        }
+
+        report.cells = this->cells;
+        report.arcs = arcs;
+        for (auto &list : boundary) report.boundary_nodes += list.size();
+        report.threads = threads;
+        report.preprocessing_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        report.flag_bytes = flags.size() * sizeof(std::uint64_t);
+        report.flag_density = arcs ? static_cast<double>(set) / static_cast<double>(arcs * this->cells) : 0.0;
+    }
+
+    std::uint32_t cell_of(Node *node) const {
+        return cell[index.at(node)];
+    }
+
+    bool has_flag(std::uint32_t slot, std::uint32_t target_cell) const {
+        std::size_t bit = static_cast<std::size_t>(slot) * cells + target_cell;
+        return (flags[bit / 64] >> (bit % 64)) & 1u;
+    }
+
+    QueryReport compare(Graph &graph, std::size_t queries, unsigned seed = 42) const;
+
+private:
+    static std::size_t popcount(std::uint64_t word) {
+        std::size_t count = 0;
+        for (; word; word &= word - 1) ++count;
+        return count;
+    }
+
+    // Biseccion recursiva: corta por la mediana del eje mas largo, repartiendo las celdas en proporcion
+    void partition(std::vector<Node *> &nodes) {
+        cell.assign(nodes.size(), 0);
+        std::vector<std::uint32_t> order(nodes.size());
+        for (std::uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+        split(nodes, order.begin(), order.end(), 0, cells);
+    }
+
+    void split(const std::vector<Node *> &nodes, std::vector<std::uint32_t>::iterator first,
+               std::vector<std::uint32_t>::iterator last, std::size_t first_cell, std::size_t count) {
+        if (first == last) return;
+        if (count == 1) {
+            for (auto it = first; it != last; ++it) cell[*it] = static_cast<std::uint32_t>(first_cell);
+            return;
+        }
+
+        float min_x = INFINITY, max_x = -INFINITY, min_y = INFINITY, max_y = -INFINITY;
+        for (auto it = first; it != last; ++it) {
+            sf::Vector2f p = nodes[*it]->coord;
+            min_x = std::min(min_x, p.x);
+            max_x = std::max(max_x, p.x);
+            min_y = std::min(min_y, p.y);
+            max_y = std::max(max_y, p.y);
+        }
+        bool by_x = (max_x - min_x) >= (max_y - min_y);
+
+        std::size_t left = count / 2;
+        auto middle = first + (last - first) * static_cast<std::ptrdiff_t>(left) / static_cast<std::ptrdiff_t>(count);
+        std::nth_element(first, middle, last, [&](std::uint32_t a, std::uint32_t b) {
+            return by_x ? nodes[a]->coord.x < nodes[b]->coord.x : nodes[a]->coord.y < nodes[b]->coord.y;
+        });
+        split(nodes, first, middle, first_cell, left);
+        split(nodes, middle, last, first_cell + left, count - left);
+    }
+};
+
+
+// *
+// ---- ArcFlagTopology ----
+// Igual que 'PointerTopology', pero solo entrega los arcos con el bit de 'target_cell' prendido.
+// *
+struct ArcFlagTopology {
+    using node_type = Node *;
+    using edge_type = Edge;
+
+    template <typename T>
+    using node_map = std::unordered_map<Node *, T>;
+
+    const ArcFlags *arc_flags = nullptr;
+    std::uint32_t target_cell = 0;
+
+    ArcFlagTopology() = default;
+
+    ArcFlagTopology(const ArcFlags *arc_flags, Node *target)
+            : arc_flags(arc_flags), target_cell(arc_flags->cell_of(target)) {}
+
+    template <typename Visit>
+    void for_each_edge(Node *u, Visit &&visit) const {
+        std::uint32_t slot = arc_flags->first_arc[arc_flags->index.at(u)];
+        for (Edge *e : u->edges) {
+            if (arc_flags->has_flag(slot++, target_cell)) {
+                visit(*e, (e->src == u) ? e->dest : e->src);
+            }
+        }
+    }
+
+    sf::Vector2f coord(Node *u) const {
+        return u->coord;
+    }
+};
+
+
+template <typename Visitor = NullVisitor>
+using ArcFlagsSearch = SearchEngine<LengthWeight, ZeroHeuristic, MinHeapQueue, StopAtTarget, Visitor, ArcFlagTopology>;
+
+
+inline ArcFlags::QueryReport ArcFlags::compare(Graph &graph, std::size_t queries, unsigned seed) const {
+    using clock = std::chrono::steady_clock;
+    QueryReport result;
+    result.queries = queries;
+
+    std::vector<Node *> nodes;
+    nodes.reserve(graph.nodes.size());
+    for (auto &[_, node] : graph.nodes) nodes.push_back(node);
+    if (nodes.empty()) return result;
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, nodes.size() - 1);
+    for (std::size_t q = 0; q < queries; ++q) {
+        Node *src = nodes[pick(rng)];
+        Node *dest = nodes[pick(rng)];
+
+        auto start = clock::now();
+        auto plain = DijkstraSearch<>().run(src, dest);
+        result.dijkstra_ms += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+        start = clock::now();
+        auto pruned = ArcFlagsSearch<>(NullVisitor(), LengthWeight(), ZeroHeuristic(), StopAtTarget(),
+                                       ArcFlagTopology(this, dest)).run(src, dest);
+        result.arc_flags_ms += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+        result.dijkstra_settled += plain.settled;
+        result.arc_flags_settled += pruned.settled;
+
+        auto expected = plain.dist.find(dest);
+        auto obtained = pruned.dist.find(dest);
+        bool reached = expected != plain.dist.end();
+        if (reached != (obtained != pruned.dist.end()) ||
+            (reached && std::abs(expected->second - obtained->second) > 1e-9 * std::max(1.0, expected->second))) {
+            ++result.mismatches;
+        }
+    }
+    return result;
+}
+
+
+#endif //HOMEWORK_GRAPH_ARC_FLAGS_H
@@ -0,0 +1,375 @@
+#ifndef HOMEWORK_GRAPH_COMPRESSED_GRAPH_H
+#define HOMEWORK_GRAPH_COMPRESSED_GRAPH_H
+
+
+#include "graph.h"
+#include "search_engine.h"
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <cmath>
+
+
+// *
+// ---- EdgeAttributes ----
+// Atributos de una arista empaquetados en 16 bits. 'max_speed' se satura en 255 y 'lanes' en 15.
+// *
+struct EdgeAttributes {
+    std::uint16_t max_speed : 8;
+    std::uint16_t lanes     : 4;
+    std::uint16_t one_way   : 1;
+
+    std::uint32_t pack() const {
+        return max_speed | (lanes << 8u) | (one_way << 12u);
+    }
+
+    static EdgeAttributes unpack(std::uint32_t bits) {
+        EdgeAttributes attributes{};
+        attributes.max_speed = bits & 0xFFu;
+        attributes.lanes = (bits >> 8u) & 0xFu;
+        attributes.one_way = (bits >> 12u) & 0x1u;
+        return attributes;
+    }
+};
+
+
+// Arista decodificada, es lo que 'CompressedGraph::for_each_edge' entrega al visitante
+struct CompressedEdge {
+    std::uint32_t dest;
+    double length;
+    EdgeAttributes attributes;
+};
+
+
+// *
+// ---- CompressedGraph ----
+// Representacion compacta y de solo lectura de 'Graph' para grafos muy grandes.
+//
+// Los vertices se renumeran en orden de curva Z (Morton) sobre sus coordenadas, asi los vecinos suelen tener
+// indices cercanos. La lista de aristas de cada vertice se guarda en 'stream' como varints (LEB128):
+//
+//     grado
+//     por cada arista, ordenadas por vecino:
+//         vecino      : la primera como zigzag(vecino - u), las siguientes como vecino - vecino anterior
+//         longitud    : punto fijo, round(length * length_scale), error <= 0.5 / length_scale
+//         atributos   : 'EdgeAttributes::pack'
+//
+// Variables miembro
+//     - length_scale  : Unidades de punto fijo por unidad de longitud
+//     - offsets       : Inicio de la lista de cada vertice en 'stream'
+//     - stream        : Listas de adyacencia codificadas
+//     - xs, ys        : Coordenadas de cada vertice (para heuristicas)
+//     - ids           : Id original ('Node::id') de cada vertice
+//     - by_id         : Indices ordenados por id original, para traducir consultas con busqueda binaria
+//
+// Funciones miembro
+//     - for_each_edge : Decodifica las aristas de 'u' y llama a visit(edge, vecino)
+//     - find          : Indice compacto de un id original
+//     - memory_bytes  : Bytes ocupados por la representacion
+// *
+class CompressedGraph {
+public:
+    double length_scale;
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint8_t> stream;
+    std::vector<float> xs, ys;
+    std::vector<std::size_t> ids;
+    std::vector<std::uint32_t> by_id;
+
+    explicit CompressedGraph(Graph &graph, double length_scale = 10.0) : length_scale(length_scale) {
+        std::vector<Node *> order;
+        order.reserve(graph.nodes.size());
+        for (auto &[_, node] : graph.nodes) order.push_back(node);
+        sort_by_morton(order);
+
+        std::unordered_map<Node *, std::uint32_t> index;
+        index.reserve(order.size());
+        ids.reserve(order.size());
+        xs.reserve(order.size());
+        ys.reserve(order.size());
+        by_id.reserve(order.size());
+        for (Node *node : order) {
+            index[node] = static_cast<std::uint32_t>(ids.size());
+            ids.push_back(node->id);
+            xs.push_back(node->coord.x);
+            ys.push_back(node->coord.y);
+            by_id.push_back(index[node]);
+        }
+        std::sort(by_id.begin(), by_id.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return ids[a] < ids[b];
+        });
+
+        PointerTopology topology;
+        std::vector<CompressedEdge> adjacency;
+        offsets.reserve(order.size() + 1);
+        for (std::uint32_t u = 0; u < order.size(); ++u) {
+            adjacency.clear();
+            topology.for_each_edge(order[u], [&](const Edge &e, Node *v) {
+                EdgeAttributes attributes{};
+                attributes.max_speed = std::clamp(e.max_speed, 0, 255);
+                attributes.lanes = std::clamp(e.lanes, 0, 15);
+                attributes.one_way = e.one_way;
+                adjacency.push_back({index[v], e.length, attributes});
+            });
+            std::sort(adjacency.begin(), adjacency.end(), [](const CompressedEdge &a, const CompressedEdge &b) {
+                return a.dest < b.dest;
+            });
+
+            offsets.push_back(static_cast<std::uint32_t>(stream.size()));
+            write_varint(adjacency.size());
+            std::uint32_t previous = u;
+            for (std::size_t k = 0; k < adjacency.size(); ++k) {
+                const CompressedEdge &e = adjacency[k];
+                if (k == 0) {
+                    write_varint(zigzag(static_cast<std::int64_t>(e.dest) - static_cast<std::int64_t>(u)));
+                } else {
+                    write_varint(e.dest - previous);
+                }
+                previous = e.dest;
+                write_varint(static_cast<std::uint64_t>(std::llround(e.length * length_scale)));
+                write_varint(e.attributes.pack());
+            }
+        }
+        offsets.push_back(static_cast<std::uint32_t>(stream.size()));
+        stream.shrink_to_fit();
+    }
+
+    std::size_t size() const {
+        return ids.size();
+    }
+
+    // Devuelve size() si el id no existe
+    std::uint32_t find(std::size_t id) const {
+        auto it = std::lower_bound(by_id.begin(), by_id.end(), id, [&](std::uint32_t u, std::size_t key) {
+            return ids[u] < key;
+        });
+        if (it == by_id.end() || ids[*it] != id) return static_cast<std::uint32_t>(size());
+        return *it;
+    }
+
+    double max_length_error() const {
+        return 0.5 / length_scale;
+    }
+
+    template <typename Visit>
+    void for_each_edge(std::uint32_t u, Visit &&visit) const {
+        const std::uint8_t *cursor = stream.data() + offsets[u];
+        std::uint64_t degree = read_varint(cursor);
+        std::uint32_t neighbour = u;
+        double inverse_scale = 1.0 / length_scale;
+
+        for (std::uint64_t k = 0; k < degree; ++k) {
+            std::uint64_t gap = read_varint(cursor);
+            neighbour = (k == 0) ? static_cast<std::uint32_t>(static_cast<std::int64_t>(u) + unzigzag(gap))
+                                 : neighbour + static_cast<std::uint32_t>(gap);
+            CompressedEdge e{};
+            e.dest = neighbour;
+            e.length = static_cast<double>(read_varint(cursor)) * inverse_scale;
+            e.attributes = EdgeAttributes::unpack(static_cast<std::uint32_t>(read_varint(cursor)));
+            visit(e, neighbour);
+        }
+    }
+
+    std::size_t memory_bytes() const {
+        return offsets.capacity() * sizeof(std::uint32_t) +
+               stream.capacity() * sizeof(std::uint8_t) +
+               (xs.capacity() + ys.capacity()) * sizeof(float) +
+               ids.capacity() * sizeof(std::size_t) +
+               by_id.capacity() * sizeof(std::uint32_t);
+    }
+
+    // Estimado de los bytes que ocupa 'graph' con 'Node'/'Edge' (sin contar lo que usa SFML para dibujar)
+    static std::size_t memory_bytes(const Graph &graph) {
+        // Nodo de std::map: tres punteros, color y la pareja clave/valor
+        constexpr std::size_t map_node = 4 * sizeof(void *) + sizeof(std::pair<const std::size_t, Node *>);
+        std::size_t bytes = graph.edges.capacity() * sizeof(Edge *) + graph.edges.size() * sizeof(Edge);
+        for (auto &[_, node] : graph.nodes) {
+            bytes += map_node + sizeof(Node) + node->edges.capacity() * sizeof(Edge *);
+        }
+        return bytes;
+    }
+
+private:
+    static std::uint64_t zigzag(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1u) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    static std::int64_t unzigzag(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1u) ^ -static_cast<std::int64_t>(value & 1u);
+    }
+
+    void write_varint(std::uint64_t value) {
+        while (value >= 0x80u) {
+            stream.push_back(static_cast<std::uint8_t>(value | 0x80u));
+            value >>= 7u;
+        }
+        stream.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    static std::uint64_t read_varint(const std::uint8_t *&cursor) {
+        std::uint64_t value = *cursor & 0x7Fu;
+        if (*cursor++ < 0x80u) return value; // Caso comun: un solo byte
+        unsigned shift = 7;
+        while (true) {
+            std::uint8_t byte = *cursor++;
+            value |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+            if (byte < 0x80u) return value;
+            shift += 7;
+        }
+    }
+
+    // Ordena los vertices por el codigo Morton de sus coordenadas cuantizadas a 16 bits por eje
+    static void sort_by_morton(std::vector<Node *> &order) {
+        if (order.empty()) return;
+        float min_x = order[0]->coord.x, max_x = min_x;
+        float min_y = order[0]->coord.y, max_y = min_y;
+        for (Node *node : order) {
+            min_x = std::min(min_x, node->coord.x);
+            max_x = std::max(max_x, node->coord.x);
+            min_y = std::min(min_y, node->coord.y);
+            max_y = std::max(max_y, node->coord.y);
+        }
+
+        auto spread = [](std::uint32_t v) {
+            v = (v | (v << 8u)) & 0x00FF00FFu;
+            v = (v | (v << 4u)) & 0x0F0F0F0Fu;
+            v = (v | (v << 2u)) & 0x33333333u;
+            v = (v | (v << 1u)) & 0x55555555u;
+            return v;
+        };
+        auto quantize = [](float value, float low, float high) {
+            if (high <= low) return std::uint32_t{0};
+            return static_cast<std::uint32_t>((value - low) / (high - low) * 65535.0f);
+        };
+
+        std::vector<std::pair<std::uint32_t, Node *>> keyed;
+        keyed.reserve(order.size());
+        for (Node *node : order) {
+            std::uint32_t code = spread(quantize(node->coord.x, min_x, max_x)) |
+                                 (spread(quantize(node->coord.y, min_y, max_y)) << 1u);
+            keyed.emplace_back(code, node);
+        }
+        std::sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) {
+            return a.first != b.first ? a.first < b.first : a.second->id < b.second->id;
+        });
+        for (std::size_t i = 0; i < keyed.size(); ++i) order[i] = keyed[i].second;
+    }
+};
+
+
+// *
+// ---- CompressedTopology ----
+// Adaptador para correr 'SearchEngine' directamente sobre 'CompressedGraph', los vertices son indices compactos.
+// *
+struct CompressedTopology {
+    using node_type = std::uint32_t;
+    using edge_type = CompressedEdge;
+
+    template <typename T>
+    using node_map = std::unordered_map<std::uint32_t, T>;
+
+    const CompressedGraph *graph = nullptr;
+
+    template <typename Visit>
+    void for_each_edge(std::uint32_t u, Visit &&visit) const {
+        graph->for_each_edge(u, std::forward<Visit>(visit));
+    }
+
+    sf::Vector2f coord(std::uint32_t u) const {
+        return {graph->xs[u], graph->ys[u]};
+    }
+};
+
+
+template <typename Visitor = NullVisitor>
+using CompressedDijkstraSearch = SearchEngine<LengthWeight, ZeroHeuristic, MinHeapQueue, StopAtTarget, Visitor,
+                                              CompressedTopology>;
+
+template <typename Visitor = NullVisitor>
+using CompressedAStarSearch = SearchEngine<LengthWeight, EuclideanHeuristic, MinHeapQueue, StopAtTarget, Visitor,
+                                           CompressedTopology>;
+
+
+// *
+// ---- CompressionReport ----
+// Compara 'queries' busquedas Dijkstra aleatorias sobre 'Graph' y sobre 'CompressedGraph'.
+//
+//     - pointer_bytes / compressed_bytes : Memoria de cada representacion
+//     - pointer_ms / compressed_ms       : Tiempo total de las busquedas
+//     - max_error                        : Mayor diferencia de distancia observada (acotada por la cuantizacion)
+//     - unreachable_mismatches           : Consultas donde solo una representacion encontro camino (deberia ser 0)
+// *
+struct CompressionReport {
+    std::size_t pointer_bytes = 0;
+    std::size_t compressed_bytes = 0;
+    double pointer_ms = 0.0;
+    double compressed_ms = 0.0;
+    double max_error = 0.0;
+    std::size_t unreachable_mismatches = 0;
+    std::size_t queries = 0;
+
+    double ratio() const {
+        return static_cast<double>(pointer_bytes) / static_cast<double>(compressed_bytes);
+    }
+
+    double slowdown() const {
+        return compressed_ms / pointer_ms;
+    }
+
+    static CompressionReport measure(Graph &graph, const CompressedGraph &compressed, std::size_t queries,
+                                     unsigned seed = 42) {
+        using clock = std::chrono::steady_clock;
+        CompressionReport report;
+        report.pointer_bytes = CompressedGraph::memory_bytes(graph);
+        report.compressed_bytes = compressed.memory_bytes();
+        report.queries = queries;
+
+        std::vector<Node *> nodes;
+        nodes.reserve(graph.nodes.size());
+        for (auto &[_, node] : graph.nodes) nodes.push_back(node);
+        if (nodes.empty()) return report;
+
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<std::size_t> pick(0, nodes.size() - 1);
+        std::vector<std::pair<Node *, Node *>> pairs(queries);
+        for (auto &pair : pairs) pair = {nodes[pick(rng)], nodes[pick(rng)]};
+
+        std::vector<double> expected;
+        auto start = clock::now();
+        for (auto &[src, dest] : pairs) {
+            auto result = DijkstraSearch<>().run(src, dest);
+            auto it = result.dist.find(dest);
+            expected.push_back(it == result.dist.end() ? INFINITY : it->second);
+        }
+        report.pointer_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+        CompressedTopology topology{&compressed};
+        std::vector<double> obtained;
+        start = clock::now();
+        for (auto &[src, dest] : pairs) {
+            std::uint32_t s = compressed.find(src->id);
+            std::uint32_t t = compressed.find(dest->id);
+            auto result = CompressedDijkstraSearch<>(NullVisitor(), LengthWeight(), ZeroHeuristic(),
+                                                     StopAtTarget(), topology).run(s, t);
+            auto it = result.dist.find(t);
+            obtained.push_back(it == result.dist.end() ? INFINITY : it->second);
+        }
+        report.compressed_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+        for (std::size_t i = 0; i < queries; ++i) {
+            if (std::isinf(expected[i]) && std::isinf(obtained[i])) continue;
+            if (std::isinf(expected[i]) || std::isinf(obtained[i])) {
+                ++report.unreachable_mismatches;
+                continue;
+            }
+            report.max_error = std::max(report.max_error, std::abs(expected[i] - obtained[i]));
+        }
+        return report;
+    }
+};
+
+
+#endif //HOMEWORK_GRAPH_COMPRESSED_GRAPH_H
@@ -0,0 +1,361 @@
+#ifndef HOMEWORK_GRAPH_DELTA_STEPPING_H
+#define HOMEWORK_GRAPH_DELTA_STEPPING_H
+
+
+#include "graph.h"
+#include "search_engine.h"
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+// *
+// ---- Barrier ----
+// Barrera reutilizable para que todos los hilos terminen una fase antes de empezar la siguiente
+// (C++17 no trae std::barrier). Las fases de delta-stepping son muy cortas, asi que se espera girando sobre un
+// contador atomico en vez de dormir en una variable de condicion; tras unas vueltas se cede el procesador para no
+// castigar a maquinas con menos nucleos que hilos.
+// *
+class Barrier {
+    std::size_t expected;
+    std::atomic<std::size_t> waiting{0};
+    std::atomic<std::size_t> generation{0};
+
+public:
+    explicit Barrier(std::size_t expected) : expected(expected) {}
+
+    void arrive_and_wait() {
+        std::size_t current = generation.load(std::memory_order_acquire);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == expected) {
+            waiting.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        for (unsigned spins = 0; generation.load(std::memory_order_acquire) == current; ++spins) {
+            if (spins >= 64) std::this_thread::yield();
+        }
+    }
+};
+
+
+// *
+// ---- CsrTopology ----
+// Recorre el mismo CSR que usa 'DeltaStepping' (vertices densos, aristas en 'offsets'/'targets'/'weights'), para
+// que Dijkstra secuencial y delta-stepping se midan sobre la misma representacion.
+// *
+struct CsrArc {
+    double length;
+};
+
+struct CsrTopology {
+    using node_type = std::uint32_t;
+    using edge_type = CsrArc;
+
+    template <typename T>
+    using node_map = DenseNodeMap<T>;
+
+    const std::vector<std::uint32_t> *offsets = nullptr;
+    const std::vector<std::uint32_t> *targets = nullptr;
+    const std::vector<double> *weights = nullptr;
+
+    template <typename Visit>
+    void for_each_edge(std::uint32_t u, Visit &&visit) const {
+        for (std::uint32_t k = (*offsets)[u]; k < (*offsets)[u + 1]; ++k) {
+            visit(CsrArc{(*weights)[k]}, (*targets)[k]);
+        }
+    }
+};
+
+using CsrDijkstra = SearchEngine<LengthWeight, ZeroHeuristic, MinHeapQueue, ExhaustiveSearch, NullVisitor, CsrTopology>;
+
+
+// *
+// ---- DeltaStepping ----
+// SSSP one-to-all multihilo (Meyer & Sanders). Los vertices se agrupan en 'buckets' de ancho 'delta' segun su
+// distancia tentativa. Se procesa el bucket no vacio de menor indice:
+//
+//     1. Mientras el bucket tenga vertices, se reparten entre los hilos y se relajan solo sus aristas livianas
+//        (peso <= delta), que pueden reinsertar vertices en el mismo bucket.
+//     2. Cuando el bucket queda vacio, cada hilo relaja las aristas pesadas de los vertices que asento, una sola vez.
+//
+// Las distancias son atomicas y se actualizan con un 'atomic min' (CAS). Cada hilo acumula sus inserciones en
+// buckets propios y, en cada ronda, filtra su propio bucket actual hacia una tajada de la frontera; las tajadas se
+// combinan con una suma de prefijos y se reparten en partes iguales, sin ninguna fase serial. Un mismo vertice puede
+// quedar en varios buckets; solo se conserva si su distancia actual cae en el bucket que se procesa y si ningun otro
+// hilo lo tomo en la misma ronda.
+//
+// Una relajacion nunca cae mas de 'max_weight / delta' buckets despues del actual, asi que los buckets son un arreglo
+// circular de ceil(max_weight / delta) + 1 posiciones (a lo sumo 'max_buckets'; si 'delta' es tan chico que no
+// alcanza, se agranda hasta 'max_weight / (max_buckets - 1)', ver 'effective_delta').
+//
+// Variables miembro
+//     - nodes         : Vertice 'Node*' de cada indice denso
+//     - index         : Indice denso de cada 'Node*'
+//     - offsets       : Inicio de la lista de adyacencia de cada vertice en 'targets'/'weights' (CSR)
+//     - targets       : Vecino de cada arista
+//     - weights       : Longitud de cada arista. Cada lista esta ordenada por peso, asi las livianas son un prefijo
+//
+// Funciones miembro
+//     - run           : Distancias desde 'src' a todos los vertices, indexadas por 'index'
+//     - suggest_delta : Un 'delta' razonable para el grafo cargado (peso medio de arista)
+//     - effective_delta : El 'delta' que realmente usa 'run' para un 'delta' pedido
+//     - compare       : Corre Dijkstra secuencial ('CsrDijkstra') y delta-stepping, verifica las distancias y mide
+//                       el speed-up
+// *
+class DeltaStepping {
+public:
+    static constexpr double infinity = std::numeric_limits<double>::infinity();
+    static constexpr std::size_t max_buckets = 1u << 16u;
+
+    //* --- Report ---
+    //     - dijkstra_ms   : Tiempo de 'CsrDijkstra' (secuencial, sobre el mismo CSR que delta-stepping)
+    //     - single_ms     : Tiempo de delta-stepping con un solo hilo
+    //     - parallel_ms   : Tiempo de delta-stepping con 'threads' hilos
+    //     - mismatches    : Vertices cuya distancia difiere de la de Dijkstra (deberia ser 0)
+    //*
+    struct Report {
+        double delta = 0.0;
+        unsigned threads = 1;
+        double dijkstra_ms = 0.0;
+        double single_ms = 0.0;
+        double parallel_ms = 0.0;
+        std::size_t reached = 0;
+        std::size_t mismatches = 0;
+
+        double speedup() const {
+            return dijkstra_ms / parallel_ms;
+        }
+
+        double scaling() const {
+            return single_ms / parallel_ms;
+        }
+    };
+
+    std::vector<Node *> nodes;
+    std::unordered_map<Node *, std::uint32_t> index;
+
+    explicit DeltaStepping(Graph &graph) {
+        nodes.reserve(graph.nodes.size());
+        for (auto &[_, node] : graph.nodes) {
+            index[node] = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back(node);
+        }
+
+        PointerTopology topology;
+        std::vector<std::pair<double, std::uint32_t>> adjacency;
+        offsets.reserve(nodes.size() + 1);
+        offsets.push_back(0);
+        for (Node *u : nodes) {
+            adjacency.clear();
+            topology.for_each_edge(u, [&](const Edge &e, Node *v) {
+                adjacency.emplace_back(e.length, index[v]);
+            });
+            std::sort(adjacency.begin(), adjacency.end());
+            for (auto &[w, v] : adjacency) {
+                weights.push_back(w);
+                targets.push_back(v);
+            }
+            offsets.push_back(static_cast<std::uint32_t>(targets.size()));
+        }
+        for (double w : weights) max_weight = std::max(max_weight, w);
+    }
+
+    double suggest_delta() const {
+        if (weights.empty()) return 1.0;
+        double total = 0.0;
+        for (double w : weights) total += w;
+        return total / static_cast<double>(weights.size());
+    }
+
+    double effective_delta(double delta) const {
+        if (!(delta > 0.0)) throw std::invalid_argument("delta debe ser positivo");
+        return std::max(delta, max_weight / static_cast<double>(max_buckets - 1));
+    }
+
+    std::vector<double> run(Node *src, double delta, unsigned threads) const {
+        std::size_t n = nodes.size();
+        threads = std::max(1u, threads);
+        delta = effective_delta(delta);
+        auto slots = static_cast<std::size_t>(std::ceil(max_weight / delta)) + 1;
+
+        std::vector<std::atomic<double>> dist(n);
+        std::vector<std::atomic<std::uint32_t>> collected(n); // Ultima ronda en la que algun hilo tomo al vertice
+        for (std::size_t v = 0; v < n; ++v) {
+            dist[v].store(infinity, std::memory_order_relaxed);
+            collected[v].store(0, std::memory_order_relaxed);
+        }
+
+        std::vector<Lane> lanes(threads);
+        for (Lane &lane : lanes) lane.buckets.resize(slots);
+
+        std::uint32_t s = index.at(src);
+        dist[s].store(0.0, std::memory_order_relaxed);
+        lanes[0].buckets[0].push_back(s);
+        lanes[0].lowest = 0;
+
+        auto bucket_of = [&](double d) {
+            return static_cast<std::uint64_t>(d / delta);
+        };
+
+        // Relaja (u, v) con distancia 'candidate'; si mejora, encola 'v' en un bucket propio del hilo
+        auto relax = [&](Lane &lane, std::uint32_t v, double candidate) {
+            double old = dist[v].load(std::memory_order_relaxed);
+            while (candidate < old) {
+                if (dist[v].compare_exchange_weak(old, candidate, std::memory_order_relaxed)) {
+                    std::uint64_t b = bucket_of(candidate);
+                    lane.buckets[b % slots].push_back(v);
+                    lane.lowest = std::min(lane.lowest, b);
+                    return;
+                }
+            }
+        };
+
+        // Primer bucket propio no vacio desde 'current'; todo lo pendiente esta a menos de 'slots' buckets
+        auto advance = [&](Lane &lane, std::uint64_t current) {
+            if (lane.lowest == Lane::none) return;
+            for (std::uint64_t b = std::max(lane.lowest, current); b < current + slots; ++b) {
+                if (!lane.buckets[b % slots].empty()) {
+                    lane.lowest = b;
+                    return;
+                }
+            }
+            lane.lowest = Lane::none;
+        };
+
+        Barrier barrier(threads);
+        auto worker = [&](unsigned t) {
+            Lane &lane = lanes[t];
+            std::uint64_t current = 0;
+            std::uint32_t round = 0;
+
+            while (true) {
+                advance(lane, current);
+                barrier.arrive_and_wait();
+                current = Lane::none;
+                for (const Lane &other : lanes) current = std::min(current, other.lowest);
+                if (current == Lane::none) break;
+                lane.settled.clear();
+
+                // Fase liviana: se repite mientras el bucket actual reciba vertices
+                while (true) {
+                    ++round;
+                    lane.slice.clear();
+                    std::vector<std::uint32_t> &bucket = lane.buckets[current % slots];
+                    for (std::uint32_t v : bucket) {
+                        if (bucket_of(dist[v].load(std::memory_order_relaxed)) != current) continue;
+                        if (collected[v].exchange(round, std::memory_order_relaxed) == round) continue;
+                        lane.slice.push_back(v);
+                    }
+                    bucket.clear();
+                    barrier.arrive_and_wait();
+
+                    // Suma de prefijos de las tajadas; al hilo 't' le toca [first, last) de la frontera combinada
+                    std::size_t total = 0;
+                    for (const Lane &other : lanes) total += other.slice.size();
+                    if (total == 0) break;
+                    std::size_t first = total * t / threads;
+                    std::size_t last = total * (t + 1) / threads;
+
+                    std::size_t offset = 0;
+                    for (const Lane &other : lanes) {
+                        std::size_t from = std::max(first, offset);
+                        std::size_t to = std::min(last, offset + other.slice.size());
+                        for (std::size_t i = from; i < to; ++i) {
+                            std::uint32_t u = other.slice[i - offset];
+                            double du = dist[u].load(std::memory_order_relaxed);
+                            lane.settled.push_back(u);
+                            for (std::uint32_t k = offsets[u]; k < offsets[u + 1] && weights[k] <= delta; ++k) {
+                                relax(lane, targets[k], du + weights[k]);
+                            }
+                        }
+                        offset += other.slice.size();
+                    }
+                    barrier.arrive_and_wait();
+                }
+
+                // Fase pesada: las distancias del bucket ya son definitivas
+                for (std::uint32_t u : lane.settled) {
+                    double du = dist[u].load(std::memory_order_relaxed);
+                    auto first = weights.begin() + offsets[u];
+                    auto last = weights.begin() + offsets[u + 1];
+                    for (auto k = std::upper_bound(first, last, delta); k != last; ++k) {
+                        relax(lane, targets[k - weights.begin()], du + *k);
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+        worker(0);
+        for (std::thread &thread : pool) thread.join();
+
+        std::vector<double> result(n);
+        for (std::size_t v = 0; v < n; ++v) result[v] = dist[v].load(std::memory_order_relaxed);
+        return result;
+    }
+
+    Report compare(Node *src, double delta, unsigned threads) const {
+        using clock = std::chrono::steady_clock;
+        auto elapsed_ms = [](clock::time_point since) {
+            return std::chrono::duration<double, std::milli>(clock::now() - since).count();
+        };
+
+        Report report;
+        report.delta = effective_delta(delta);
+        report.threads = std::max(1u, threads);
+
+        auto start = clock::now();
+        CsrTopology topology{&offsets, &targets, &weights};
+        std::uint32_t source = index.at(src);
+        auto reference = CsrDijkstra(NullVisitor(), LengthWeight(), ZeroHeuristic(), ExhaustiveSearch(), topology)
+                .run(source, source);
+        report.dijkstra_ms = elapsed_ms(start);
+
+        start = clock::now();
+        run(src, delta, 1);
+        report.single_ms = elapsed_ms(start);
+
+        start = clock::now();
+        std::vector<double> dist = run(src, delta, report.threads);
+        report.parallel_ms = elapsed_ms(start);
+
+        for (std::size_t v = 0; v < nodes.size(); ++v) {
+            auto it = reference.dist.find(static_cast<std::uint32_t>(v));
+            double expected = (it == reference.dist.end()) ? infinity : it->second;
+            if (expected != infinity) ++report.reached;
+            if (std::abs(expected - dist[v]) > 1e-6 * std::max(1.0, expected)) ++report.mismatches;
+        }
+        return report;
+    }
+
+private:
+    //* --- Lane ---
+    // Estado propio de cada hilo en 'run', alineado a una linea de cache para no compartirla con otros hilos.
+    //     - buckets       : Buckets circulares, buckets[b % slots]
+    //     - slice         : Parte de la frontera de la ronda actual que filtro este hilo
+    //     - settled       : Vertices procesados en el bucket actual (para la fase pesada)
+    //     - lowest        : Menor bucket propio que puede no estar vacio, 'none' si no hay ninguno
+    //*
+    struct alignas(64) Lane {
+        static constexpr std::uint64_t none = std::numeric_limits<std::uint64_t>::max();
+
+        std::vector<std::vector<std::uint32_t>> buckets;
+        std::vector<std::uint32_t> slice;
+        std::vector<std::uint32_t> settled;
+        std::uint64_t lowest = none;
+    };
+
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> targets;
+    std::vector<double> weights;
+    double max_weight = 0.0;
+};
+
+
+#endif //HOMEWORK_GRAPH_DELTA_STEPPING_H
@@ -92,6 +92,21 @@ public:
                                 path_finding_manager.exec(graph, AStar);
                                 break;
                             }
+                            // F = Ejecutar Dijkstra con arc flags (preprocesa la primera vez)
+                            case sf::Keyboard::F: {
+                                path_finding_manager.exec(graph, ArcFlagDijkstra);
+                                break;
+                            }
+                            // P = Delta-stepping paralelo one-to-all desde 'src', imprime el speed-up frente a Dijkstra
+                            case sf::Keyboard::P: {
+                                path_finding_manager.delta_stepping(graph);
+                                break;
+                            }
+                            // C = Compara el grafo comprimido contra el grafo de punteros (memoria y tiempo)
+                            case sf::Keyboard::C: {
+                                path_finding_manager.compression_report(graph);
+                                break;
+                            }
                             // R = Limpia la ultima simulación realizada.
                             //     También restaura los valores de 'src' y 'dest' a nullptr.
                             case sf::Keyboard::R: {
@@ -0,0 +1,146 @@
+#ifndef HOMEWORK_GRAPH_LOAD_GENERATOR_H
+#define HOMEWORK_GRAPH_LOAD_GENERATOR_H
+
+
+#include "routing_protocol.h"
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+// *
+// ---- LoadGenerator ----
+// Cliente de carga para 'RoutingServer'. Manda pedidos 'Route' entre vertices aleatorios por una sola conexion,
+// manteniendo hasta 'concurrency' pedidos sin responder, y mide el throughput y la latencia de cada uno.
+//
+// Funciones miembro
+//     - connect       : Abre la conexion con el socket del servidor
+//     - run           : Envia 'requests' pedidos y devuelve el 'Report'
+// *
+class LoadGenerator {
+public:
+    //* --- Report ---
+    //     - qps           : Respuestas por segundo
+    //     - p50 ... max   : Latencia en ms, desde que se envio el pedido hasta que llego su respuesta
+    //     - statuses      : Cantidad de respuestas por cada 'Status'
+    //*
+    struct Report {
+        std::size_t requests = 0;
+        double seconds = 0.0;
+        double qps = 0.0;
+        double p50 = 0.0, p90 = 0.0, p99 = 0.0, p999 = 0.0, max = 0.0;
+        std::map<Status, std::size_t> statuses;
+    };
+
+    ~LoadGenerator() {
+        if (fd >= 0) close(fd);
+    }
+
+    bool connect(const std::string &socket_path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socket_path.size() >= sizeof(address.sun_path)) return false;
+        std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        return fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+    }
+
+    Report run(const std::vector<std::size_t> &ids, std::size_t requests, std::size_t concurrency,
+               std::uint32_t deadline_ms, unsigned seed = 42) {
+        using clock = std::chrono::steady_clock;
+        Report report;
+        if (ids.empty()) return report;
+
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<std::size_t> pick(0, ids.size() - 1);
+        std::unordered_map<std::uint32_t, clock::time_point> sent_at;
+        std::vector<double> latencies;
+        latencies.reserve(requests);
+
+        auto start = clock::now();
+        std::uint32_t next = 0;
+        while (latencies.size() < requests) {
+            while (next < requests && sent_at.size() < std::max<std::size_t>(1, concurrency)) {
+                ByteWriter writer;
+                writer.put(next);
+                writer.put(static_cast<std::uint8_t>(RequestType::Route));
+                writer.put(deadline_ms);
+                writer.put(static_cast<std::uint64_t>(ids[pick(rng)]));
+                writer.put(static_cast<std::uint64_t>(ids[pick(rng)]));
+                sent_at[next++] = clock::now();
+                if (!write_all(writer.finish())) return report;
+            }
+
+            std::vector<std::uint8_t> body;
+            if (!read_frame(body)) return report;
+            ByteReader reader(body.data(), body.size());
+            auto id = reader.get<std::uint32_t>();
+            auto status = static_cast<Status>(reader.get<std::uint8_t>());
+            auto it = sent_at.find(id);
+            if (!reader.ok || it == sent_at.end()) continue;
+
+            latencies.push_back(std::chrono::duration<double, std::milli>(clock::now() - it->second).count());
+            sent_at.erase(it);
+            ++report.statuses[status];
+        }
+
+        report.requests = latencies.size();
+        report.seconds = std::chrono::duration<double>(clock::now() - start).count();
+        report.qps = static_cast<double>(report.requests) / report.seconds;
+        if (latencies.empty()) return report;
+
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) {
+            auto rank = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1));
+            return latencies[rank];
+        };
+        report.p50 = percentile(0.50);
+        report.p90 = percentile(0.90);
+        report.p99 = percentile(0.99);
+        report.p999 = percentile(0.999);
+        report.max = latencies.back();
+        return report;
+    }
+
+private:
+    int fd = -1;
+
+    bool write_all(const std::vector<std::uint8_t> &frame) {
+        std::size_t written = 0;
+        while (written < frame.size()) {
+            ssize_t n = ::send(fd, frame.data() + written, frame.size() - written, 0);
+            if (n <= 0) return false;
+            written += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    bool read_exact(std::uint8_t *data, std::size_t size) {
+        std::size_t received = 0;
+        while (received < size) {
+            ssize_t n = recv(fd, data + received, size - received, 0);
+            if (n <= 0) return false;
+            received += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    bool read_frame(std::vector<std::uint8_t> &body) {
+        std::uint32_t length;
+        if (!read_exact(reinterpret_cast<std::uint8_t *>(&length), sizeof(length))) return false;
+        if (length > max_frame_length) return false;
+        body.resize(length);
+        return read_exact(body.data(), length);
+    }
+};
+
+
+#endif //HOMEWORK_GRAPH_LOAD_GENERATOR_H
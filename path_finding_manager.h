@@ -8,10 +8,13 @@
 
 #include "window_manager.h"
 #include "graph.h"
+#include "search_engine.h"
+#include "delta_stepping.h"
+#include "compressed_graph.h"
+#include "arc_flags.h"
 #include <unordered_map>
-#include <set>
-#include <queue>
-#include <cmath>
+#include <memory>
+#include <thread>
 
 
 // Este enum sirve para identificar el algoritmo que el usuario desea simular
@@ -19,7 +22,8 @@ enum Algorithm {
     None,
     Dijkstra,
     BFS,
-    AStar
+    AStar,
+    ArcFlagDijkstra
 };
 
 
@@ -34,119 +38,73 @@ enum Algorithm {
 //     - window_manager : Instancia del manejador de ventana, es utilizado para dibujar cada paso del algoritmo
 //     - src            : Nodo incial del que se parte en el algoritmo seleccionado
 //     - dest           : Nodo al que se quiere llegar desde 'src'
+//     - delta          : Ancho de bucket para 'delta_stepping', si es 0 se usa 'DeltaStepping::suggest_delta'
+//     - threads        : Hilos para 'delta_stepping' y el preprocesamiento de arc flags, si es 0 se usan todos
+//     - cells          : Cantidad de celdas de la particion de 'ArcFlags'
 //*
 class PathFindingManager {
     WindowManager *window_manager;
     std::vector<sfLine> path;
     std::vector<sfLine> visited_edges;
+    std::unique_ptr<DeltaStepping> delta_engine;
+    std::unique_ptr<ArcFlags> arc_flags;
 
-    struct Entry {
-        Node* node;
-        double dist;
-
-        bool operator < (const Entry& other) const {
-            return dist < other.dist;
-        }
-    };
+    //* --- RenderVisitor ---
+    // Visitante del 'SearchEngine' que dibuja cada arista relajada, con el color propio de cada algoritmo.
+    //*
+    struct RenderVisitor {
+        PathFindingManager *manager;
+        sf::Color color;
 
-    void dijkstra(Graph &graph) {
-        std::unordered_map<Node*, double> dist;
-        std::unordered_map<Node*, Node*> parent;
-        auto cmp = [&](Node* a, Node* b) { return dist[a] > dist[b]; };
-        std::priority_queue<Node*, std::vector<Node*>, decltype(cmp)> pq(cmp);
+        void on_settle(Node *) {}
 
-        for (auto& [_, node] : graph.nodes) {
-            dist[node] = INFINITY;
-        }
-        dist[src] = 0.0;
-        pq.push(src);
-
-        while (!pq.empty()) {
-            Node* u = pq.top(); pq.pop();
-            if (u == dest) break;
-
-            for (Edge* e : u->edges) {
-                Node* v = (e->src == u) ? e->dest : e->src;
-                double weight = e->length;
-                if (dist[u] + weight < dist[v]) {
-                    dist[v] = dist[u] + weight;
-                    parent[v] = u;
-                    pq.push(v);
-                    visited_edges.emplace_back(u->coord, v->coord, sf::Color::Blue, 1.f);
-                    render();
-                }
-            }
+        void on_relax(Node *u, Node *v) {
+            manager->visited_edges.emplace_back(u->coord, v->coord, color, 1.f);
+            manager->render();
         }
+    };
 
-        set_final_path(parent);
+    void dijkstra(Graph &) {
+        auto result = DijkstraSearch<RenderVisitor>(RenderVisitor{this, sf::Color::Blue}).run(src, dest);
+        set_final_path(result.parent);
     }
 
-    void bfs(Graph &graph) {
-        std::unordered_map<Node*, Node*> parent;
-        std::set<Node*> visited;
-        std::queue<Node*> q;
-
-        visited.insert(src);
-        q.push(src);
-
-        while (!q.empty()) {
-            Node* u = q.front(); q.pop();
-            if (u == dest) break;
-
-            for (Edge* e : u->edges) {
-                Node* v = (e->src == u) ? e->dest : e->src;
-                if (!visited.count(v)) {
-                    visited.insert(v);
-                    parent[v] = u;
-                    q.push(v);
-                    visited_edges.emplace_back(u->coord, v->coord, sf::Color::Yellow, 1.f);
-                    render();
-                }
-            }
-        }
-
-        set_final_path(parent);
+    void bfs(Graph &) {
+        auto result = BFSSearch<RenderVisitor>(RenderVisitor{this, sf::Color::Yellow}).run(src, dest);
+        set_final_path(result.parent);
     }
 
-
-    double heuristic(Node* a, Node* b) {
-        float dx = a->coord.x - b->coord.x;
-        float dy = a->coord.y - b->coord.y;
-        return std::sqrt(dx * dx + dy * dy);
+    void a_star(Graph &) {
+        auto result = AStarSearch<RenderVisitor>(RenderVisitor{this, sf::Color::Magenta}).run(src, dest);
+        set_final_path(result.parent);
     }
 
-    void a_star(Graph &graph) {
-        std::unordered_map<Node*, double> g_score, f_score;
-        std::unordered_map<Node*, Node*> parent;
-        auto cmp = [&](Node* a, Node* b) { return f_score[a] > f_score[b]; };
-        std::priority_queue<Node*, std::vector<Node*>, decltype(cmp)> open_set(cmp);
-
-        for (auto& [_, node] : graph.nodes) {
-            g_score[node] = f_score[node] = INFINITY;
-        }
-        g_score[src] = 0.0;
-        f_score[src] = heuristic(src, dest);
-        open_set.push(src);
-
-        while (!open_set.empty()) {
-            Node* current = open_set.top(); open_set.pop();
-            if (current == dest) break;
-
-            for (Edge* e : current->edges) {
-                Node* neighbor = (e->src == current) ? e->dest : e->src;
-                double tentative_g = g_score[current] + e->length;
-                if (tentative_g < g_score[neighbor]) {
-                    parent[neighbor] = current;
-                    g_score[neighbor] = tentative_g;
-                    f_score[neighbor] = tentative_g + heuristic(neighbor, dest);
-                    open_set.push(neighbor);
-                    visited_edges.emplace_back(current->coord, neighbor->coord, sf::Color::Magenta, 1.f);
-                    render();
-                }
-            }
+    //* --- arc_flag_dijkstra ---
+    // Dijkstra que salta las aristas sin el flag de la celda de 'dest'. La primera vez preprocesa los arc flags
+    // e imprime su costo; en cada consulta imprime cuantos vertices se asentaron frente a Dijkstra sin flags.
+    //*
+    void arc_flag_dijkstra(Graph &graph) {
+        if (!arc_flags) {
+            arc_flags = std::make_unique<ArcFlags>(graph, cells, threads);
+            const ArcFlags::Report &report = arc_flags->report;
+            ArcFlags::QueryReport queries = arc_flags->compare(graph, 100);
+            std::cout << "arc flags (" << report.cells << " celdas, " << report.threads << " hilos)\n"
+                      << "    preprocesamiento : " << report.preprocessing_ms << " ms, "
+                      << report.boundary_nodes << " vertices frontera\n"
+                      << "    memoria flags    : " << report.flag_bytes << " bytes para " << report.arcs
+                      << " arcos (" << report.flag_density * 100.0 << "% de bits prendidos)\n"
+                      << "    " << queries.queries << " consultas   : " << queries.dijkstra_settled << " -> "
+                      << queries.arc_flags_settled << " vertices asentados (" << queries.reduction() << "x), "
+                      << queries.dijkstra_ms << " -> " << queries.arc_flags_ms << " ms, "
+                      << queries.mismatches << " distancias distintas" << std::endl;
         }
 
-        set_final_path(parent);
+        std::size_t plain = DijkstraSearch<>().run(src, dest).settled;
+        auto result = ArcFlagsSearch<RenderVisitor>(RenderVisitor{this, sf::Color::Red}, LengthWeight(),
+                                                    ZeroHeuristic(), StopAtTarget(),
+                                                    ArcFlagTopology(arc_flags.get(), dest)).run(src, dest);
+        std::cout << "arc flags: " << result.settled << " vertices asentados, dijkstra: " << plain << std::endl;
+        set_final_path(result.parent);
     }
 
 
@@ -187,6 +145,9 @@ class PathFindingManager {
 public:
     Node *src = nullptr;
     Node *dest = nullptr;
+    double delta = 0.0;
+    unsigned threads = 0;
+    std::size_t cells = 32;
 
     explicit PathFindingManager(WindowManager *window_manager) : window_manager(window_manager) {}
 
@@ -203,11 +164,54 @@ public:
             case AStar:
                 a_star(graph);
                 break;
+            case ArcFlagDijkstra:
+                arc_flag_dijkstra(graph);
+                break;
             default:
                 break;
         }
     }
 
+    //* --- delta_stepping ---
+    // Calcula las distancias one-to-all desde 'src' con delta-stepping multihilo, las compara con Dijkstra
+    // secuencial e imprime los tiempos y el speed-up. El CSR se construye la primera vez que se llama.
+    //*
+    void delta_stepping(Graph &graph) {
+        if (src == nullptr) return;
+        if (!delta_engine) delta_engine = std::make_unique<DeltaStepping>(graph);
+
+        double width = (delta > 0.0) ? delta : delta_engine->suggest_delta();
+        unsigned workers = (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+        DeltaStepping::Report report = delta_engine->compare(src, width, workers);
+
+        std::cout << "delta-stepping (delta = " << report.delta << ", " << report.threads << " hilos)\n"
+                  << "    dijkstra csr  : " << report.dijkstra_ms << " ms\n"
+                  << "    1 hilo        : " << report.single_ms << " ms\n"
+                  << "    " << report.threads << " hilos       : " << report.parallel_ms << " ms\n"
+                  << "    speed-up      : " << report.speedup() << "x vs dijkstra, "
+                  << report.scaling() << "x vs 1 hilo\n"
+                  << "    alcanzados    : " << report.reached << ", distancias distintas: " << report.mismatches
+                  << std::endl;
+    }
+
+    //* --- compression_report ---
+    // Construye 'CompressedGraph' a partir de 'graph', corre 'queries' busquedas Dijkstra aleatorias sobre ambas
+    // representaciones e imprime la memoria, el tiempo y el error de distancia de cada una.
+    //*
+    void compression_report(Graph &graph, std::size_t queries = 100) {
+        CompressedGraph compressed(graph);
+        CompressionReport report = CompressionReport::measure(graph, compressed, queries);
+
+        std::cout << "grafo comprimido (" << queries << " consultas)\n"
+                  << "    memoria       : " << report.pointer_bytes << " -> " << report.compressed_bytes
+                  << " bytes (" << report.ratio() << "x menos)\n"
+                  << "    tiempo        : " << report.pointer_ms << " -> " << report.compressed_ms
+                  << " ms (" << report.slowdown() << "x)\n"
+                  << "    error maximo  : " << report.max_error
+                  << " (cota por arista: " << compressed.max_length_error() << ")\n"
+                  << "    alcanzabilidad: " << report.unreachable_mismatches << " consultas distintas" << std::endl;
+    }
+
     void reset() {
         path.clear();
         visited_edges.clear();
@@ -0,0 +1,37 @@
+#include "node.h"
+#include "load_generator.h"
+
+// Uso: routing_client [nodes.csv] [socket] [pedidos] [concurrencia] [deadline_ms]
+
+int main(int argc, char *argv[]) {
+    std::string nodes_path = (argc > 1) ? argv[1] : "nodes.csv";
+    std::string socket_path = (argc > 2) ? argv[2] : "/tmp/homework_graph.sock";
+    std::size_t requests = (argc > 3) ? std::stoul(argv[3]) : 10000;
+    std::size_t concurrency = (argc > 4) ? std::stoul(argv[4]) : 64;
+    auto deadline_ms = static_cast<std::uint32_t>((argc > 5) ? std::stoul(argv[5]) : 0);
+
+    // Solo se necesitan los ids para armar pedidos entre vertices existentes
+    std::map<std::size_t, Node *> nodes;
+    Node::parse_csv(nodes_path, nodes);
+    std::vector<std::size_t> ids;
+    for (auto &[id, node] : nodes) {
+        ids.push_back(id);
+        delete node;
+    }
+
+    LoadGenerator generator;
+    if (!generator.connect(socket_path)) {
+        std::cerr << "No se pudo conectar a " << socket_path << "\n";
+        return 1;
+    }
+
+    LoadGenerator::Report report = generator.run(ids, requests, concurrency, deadline_ms);
+    std::cout << report.requests << " pedidos en " << report.seconds << " s, concurrencia " << concurrency << "\n"
+              << "    qps           : " << report.qps << "\n"
+              << "    latencia (ms) : p50 " << report.p50 << ", p90 " << report.p90 << ", p99 " << report.p99
+              << ", p99.9 " << report.p999 << ", max " << report.max << "\n";
+    for (auto &[status, count] : report.statuses) {
+        std::cout << "    status " << static_cast<int>(status) << "      : " << count << "\n";
+    }
+    return report.requests == requests ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#ifndef HOMEWORK_GRAPH_ROUTING_PROTOCOL_H
+#define HOMEWORK_GRAPH_ROUTING_PROTOCOL_H
+
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+// *
+// ---- Protocolo del servidor de rutas ----
+// Protocolo binario local (mismo host, por eso se usa el orden de bytes nativo). Cada mensaje es un frame:
+//
+//     u32 length      : Bytes que siguen a este campo
+//     u32 id          : Identificador elegido por el cliente, se repite en la respuesta. Reusar el id de un pedido
+//                       que sigue en curso en la misma conexion se responde con 'BadRequest'
+//     u8  type/status : Tipo de pedido (RequestType) o estado de la respuesta (Status)
+//     ...             : Cuerpo
+//
+// Pedidos                                                  Respuesta (si status == Ok)
+//     Route    : u32 deadline_ms, u64 src, u64 dest           f64 distancia, u32 n, u64 ids[n]
+//     Matrix   : u32 deadline_ms, u32 n, u32 m,               u32 n, u32 m, f64 dist[n * m] (por filas)
+//                u64 sources[n], u64 targets[m]
+//     Nearest  : u32 deadline_ms, f32 x, f32 y                u64 id, f64 distancia euclidiana
+//     Cancel   : u32 id del pedido a cancelar                 (vacio)
+//     Reload   : u32 n, char nodes_path[n],                   u64 vertices, u64 aristas
+//                u32 m, char edges_path[m]  (vacios = los mismos csv)
+//
+// 'deadline_ms' es relativo a la llegada al servidor, 0 = sin limite. Una distancia infinita significa que no hay
+// camino.
+//
+// 'Cancel' y 'Reload' se atienden aunque el servidor este saturado. Si el pedido cancelado todavia no habia entrado
+// a la cola se descarta y se responde con 'Cancelled' antes que la respuesta 'Ok' del propio 'Cancel'.
+// *
+
+enum class RequestType : std::uint8_t {
+    Route = 1,
+    Matrix = 2,
+    Nearest = 3,
+    Cancel = 4,
+    Reload = 5
+};
+
+enum class Status : std::uint8_t {
+    Ok = 0,
+    NotFound = 1,
+    DeadlineExceeded = 2,
+    Cancelled = 3,
+    Overloaded = 4,
+    BadRequest = 5
+};
+
+// Frames mas grandes se consideran corruptos y se cierra la conexion
+constexpr std::uint32_t max_frame_length = 1u << 20u;
+
+
+// Escribe valores en un buffer, reservando al inicio el prefijo de longitud del frame
+class ByteWriter {
+    std::vector<std::uint8_t> bytes;
+
+public:
+    ByteWriter() : bytes(sizeof(std::uint32_t)) {}
+
+    template <typename T>
+    void put(const T &value) {
+        std::size_t at = bytes.size();
+        bytes.resize(at + sizeof(T));
+        std::memcpy(bytes.data() + at, &value, sizeof(T));
+    }
+
+    void put_string(const std::string &value) {
+        put(static_cast<std::uint32_t>(value.size()));
+        bytes.insert(bytes.end(), value.begin(), value.end());
+    }
+
+    // Completa el prefijo de longitud y devuelve el frame listo para enviar
+    std::vector<std::uint8_t> finish() {
+        std::uint32_t length = static_cast<std::uint32_t>(bytes.size() - sizeof(std::uint32_t));
+        std::memcpy(bytes.data(), &length, sizeof(length));
+        return std::move(bytes);
+    }
+};
+
+
+// Lee valores de un cuerpo ya recibido. Si se lee mas alla del final, 'ok' pasa a falso y se devuelven ceros
+class ByteReader {
+    const std::uint8_t *cursor;
+    const std::uint8_t *end;
+
+public:
+    bool ok = true;
+
+    ByteReader(const std::uint8_t *data, std::size_t size) : cursor(data), end(data + size) {}
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (static_cast<std::size_t>(end - cursor) < sizeof(T)) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+
+    std::string get_string() {
+        std::uint32_t size = get<std::uint32_t>();
+        if (static_cast<std::size_t>(end - cursor) < size) {
+            ok = false;
+            return {};
+        }
+        std::string value(reinterpret_cast<const char *>(cursor), size);
+        cursor += size;
+        return value;
+    }
+
+    std::size_t remaining() const {
+        return static_cast<std::size_t>(end - cursor);
+    }
+};
+
+
+#endif //HOMEWORK_GRAPH_ROUTING_PROTOCOL_H
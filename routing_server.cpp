@@ -0,0 +1,40 @@
+#include "routing_server.h"
+#include <csignal>
+
+// Uso: routing_server [nodes.csv] [edges.csv] [socket] [workers]
+
+RoutingServer *running = nullptr;
+
+void on_signal(int) {
+    if (running != nullptr) running->stop();
+}
+
+int main(int argc, char *argv[]) {
+    std::string nodes_path = (argc > 1) ? argv[1] : "nodes.csv";
+    std::string edges_path = (argc > 2) ? argv[2] : "edges.csv";
+
+    RoutingServer::Options options;
+    if (argc > 3) options.socket_path = argv[3];
+    options.workers = (argc > 4) ? std::stoul(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+
+    auto graph = std::make_shared<RoutingGraph>(nodes_path, edges_path);
+    if (graph->graph.nodes.empty()) {
+        std::cerr << "No se pudo leer el grafo de " << nodes_path << " / " << edges_path << "\n";
+        return 1;
+    }
+    std::cout << "grafo: " << graph->graph.nodes.size() << " vertices, " << graph->graph.edges.size()
+              << " aristas\n" << "escuchando en " << options.socket_path << " con " << options.workers
+              << " workers" << std::endl;
+
+    RoutingServer server(graph, options);
+    running = &server;
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (!server.serve()) {
+        std::cerr << "No se pudo abrir " << options.socket_path << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,761 @@
+#ifndef HOMEWORK_GRAPH_ROUTING_SERVER_H
+#define HOMEWORK_GRAPH_ROUTING_SERVER_H
+
+
+#include "graph.h"
+#include "search_engine.h"
+#include "routing_protocol.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <condition_variable>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <cerrno>
+#include <cmath>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+using RoutingClock = std::chrono::steady_clock;
+
+
+// *
+// ---- RoutingGraph ----
+// Grafo cargado por el servidor, sin ventana. Es inmutable una vez construido: los workers lo comparten por
+// 'std::shared_ptr' y una recarga simplemente publica uno nuevo.
+//
+// Variables miembro
+//     - graph         : El grafo leido de los csv
+//     - nodes_path    : csv de vertices con el que se construyo
+//     - edges_path    : csv de aristas con el que se construyo
+//     - cells         : Grilla uniforme de vertices para 'nearest'
+//
+// Funciones miembro
+//     - find          : Vertice con un id dado, nullptr si no existe
+//     - nearest       : Vertice mas cercano a (x, y)
+// *
+struct RoutingGraph {
+    Graph graph{nullptr};
+    std::string nodes_path;
+    std::string edges_path;
+
+    float min_x = 0.f, min_y = 0.f, max_x = 0.f, max_y = 0.f;
+    float cell = 1.f;
+    std::size_t cols = 0, rows = 0;
+    std::vector<std::vector<Node *>> cells;
+
+    RoutingGraph(const std::string &nodes_path, const std::string &edges_path)
+            : nodes_path(nodes_path), edges_path(edges_path) {
+        graph.parse_csv(nodes_path, edges_path);
+        build_grid();
+    }
+
+    RoutingGraph(const RoutingGraph &) = delete;
+    RoutingGraph &operator=(const RoutingGraph &) = delete;
+
+    // 'Graph' no libera sus vertices ni aristas; aqui si, porque una recarga descarta el grafo anterior
+    ~RoutingGraph() {
+        for (Edge *edge : graph.edges) delete edge;
+        for (auto &[_, node] : graph.nodes) delete node;
+    }
+
+    Node *find(std::size_t id) const {
+        auto it = graph.nodes.find(id);
+        return (it == graph.nodes.end()) ? nullptr : it->second;
+    }
+
+    // Busca por anillos de celdas alrededor de (x, y) hasta que ningun anillo mas lejano pueda mejorar el resultado
+    Node *nearest(float x, float y, double &distance) const {
+        Node *best = nullptr;
+        distance = INFINITY;
+        if (cells.empty()) return best;
+
+        // Proyectar la consulta sobre la caja del grafo; 'outside' es cuanto quedo fuera
+        float px = std::clamp(x, min_x, max_x);
+        float py = std::clamp(y, min_y, max_y);
+        double outside = std::hypot(x - px, y - py);
+        auto cx = static_cast<long>(cell_of(px, min_x, cols));
+        auto cy = static_cast<long>(cell_of(py, min_y, rows));
+
+        auto last_col = static_cast<long>(cols) - 1;
+        auto last_row = static_cast<long>(rows) - 1;
+        auto scan_cell = [&](long gx, long gy) {
+            for (Node *node : cells[gy * cols + gx]) {
+                double d = std::hypot(node->coord.x - x, node->coord.y - y);
+                if (d < distance) {
+                    distance = d;
+                    best = node;
+                }
+            }
+        };
+
+        long max_ring = static_cast<long>(std::max(cols, rows));
+        for (long ring = 0; ring <= max_ring; ++ring) {
+            // Solo el borde del cuadrado de lado 2 * ring + 1, recortado a la grilla: filas de arriba y abajo
+            // completas, columnas de los costados sin las esquinas
+            long x0 = std::max(cx - ring, 0L), x1 = std::min(cx + ring, last_col);
+            if (cy - ring >= 0) for (long gx = x0; gx <= x1; ++gx) scan_cell(gx, cy - ring);
+            if (ring > 0 && cy + ring <= last_row) for (long gx = x0; gx <= x1; ++gx) scan_cell(gx, cy + ring);
+            long y0 = std::max(cy - ring + 1, 0L), y1 = std::min(cy + ring - 1, last_row);
+            if (cx - ring >= 0) for (long gy = y0; gy <= y1; ++gy) scan_cell(cx - ring, gy);
+            if (ring > 0 && cx + ring <= last_col) for (long gy = y0; gy <= y1; ++gy) scan_cell(cx + ring, gy);
+            // Todo vertice fuera de los anillos ya vistos esta a mas de 'ring * cell' de la proyeccion
+            double bound = ring * static_cast<double>(cell);
+            if (best != nullptr && distance * distance <= bound * bound + outside * outside) break;
+        }
+        return best;
+    }
+
+private:
+    std::size_t cell_of(float value, float low, std::size_t count) const {
+        auto index = static_cast<std::size_t>((value - low) / cell);
+        return std::min(index, count - 1);
+    }
+
+    void build_grid() {
+        if (graph.nodes.empty()) return;
+        min_x = min_y = INFINITY;
+        max_x = max_y = -INFINITY;
+        for (auto &[_, node] : graph.nodes) {
+            min_x = std::min(min_x, node->coord.x);
+            min_y = std::min(min_y, node->coord.y);
+            max_x = std::max(max_x, node->coord.x);
+            max_y = std::max(max_y, node->coord.y);
+        }
+
+        // Alrededor de dos vertices por celda
+        auto side = static_cast<std::size_t>(std::sqrt(graph.nodes.size() / 2.0)) + 1;
+        cell = std::max(max_x - min_x, max_y - min_y) / static_cast<float>(side);
+        if (cell <= 0.f) cell = 1.f;
+        cols = cell_of(max_x, min_x, side + 1) + 1;
+        rows = cell_of(max_y, min_y, side + 1) + 1;
+        cells.assign(cols * rows, {});
+        for (auto &[_, node] : graph.nodes) {
+            cells[cell_of(node->coord.y, min_y, rows) * cols + cell_of(node->coord.x, min_x, cols)].push_back(node);
+        }
+    }
+};
+
+
+// *
+// ---- Interruptible ----
+// Politica de parada para 'SearchEngine' que envuelve a otra ('StopAtTarget', 'StopAtAll', ...) y ademas corta
+// la busqueda si el pedido se cancelo o vencio su deadline. El reloj se consulta cada 256 vertices asentados.
+// *
+template <typename Inner>
+struct Interruptible {
+    Inner inner;
+    const std::atomic<bool> *cancelled;
+    RoutingClock::time_point deadline;
+    bool *interrupted;
+    std::size_t ticks = 0;
+
+    template <typename NodeT>
+    bool operator()(NodeT settled, NodeT target) {
+        if ((++ticks & 255u) == 0 &&
+            (cancelled->load(std::memory_order_relaxed) || RoutingClock::now() > deadline)) {
+            *interrupted = true;
+            return true;
+        }
+        return inner(settled, target);
+    }
+};
+
+
+// Pedido decodificado que espera (o esta siendo atendido por) un worker
+struct RoutingJob {
+    std::uint64_t connection = 0;
+    std::uint32_t id = 0;
+    RequestType type = RequestType::Route;
+    RoutingClock::time_point deadline = RoutingClock::time_point::max();
+    std::atomic<bool> cancelled{false};
+
+    std::vector<std::size_t> sources;   // Route: sources[0]
+    std::vector<std::size_t> targets;   // Route: targets[0]
+    float x = 0.f, y = 0.f;             // Nearest
+};
+
+// Respuesta lista para enviar por la conexion 'connection'
+struct RoutingReply {
+    std::uint64_t connection;
+    std::uint32_t id;
+    std::vector<std::uint8_t> frame;
+};
+
+
+// *
+// ---- RoutingServer ----
+// Servidor de rutas sobre un socket Unix. Un solo hilo de I/O atiende todas las conexiones con poll(); los pedidos
+// que llegan en una misma vuelta del bucle se encolan juntos y cada worker toma un lote de ceil(cola / workers)
+// pedidos, a lo sumo 'max_batch', para que un worker no se quede con toda la cola mientras los demas duermen. Cada
+// respuesta se entrega apenas esta lista, sin esperar al resto del lote.
+//
+//     - Backpressure  : Con la cola llena ('queue_capacity') los pedidos nuevos (Route / Matrix / Nearest) se
+//                       guardan sin decodificar en 'Connection::held' y se encolan en orden cuando hay lugar; 'Cancel'
+//                       y 'Reload' se siguen atendiendo al llegar, asi un cliente puede cancelar lo que ya encolo.
+//                       Se deja de leer de una conexion si acumula 'max_output' bytes retenidos o sin enviar (el
+//                       cliente se bloquea al escribir). Pedidos que llegan con la cola al doble de su capacidad se
+//                       rechazan con 'Overloaded'.
+//     - Deadlines     : Se revisan al sacar el pedido de la cola y durante la busqueda ('Interruptible').
+//     - Cancelacion   : Un pedido 'Cancel' o el cierre de la conexion marcan los pedidos pendientes.
+//     - Recarga       : 'Reload' lee el grafo nuevo en otro hilo y lo publica con std::atomic_store; los pedidos en
+//                       curso terminan con el grafo anterior, que se libera cuando el ultimo lo suelta.
+// *
+class RoutingServer {
+public:
+    struct Options {
+        std::string socket_path = "/tmp/homework_graph.sock";
+        unsigned workers = 4;
+        std::size_t queue_capacity = 1024;
+        std::size_t max_batch = 32;
+        std::size_t max_output = 1u << 20u;
+        std::size_t max_matrix_cells = 100000;
+    };
+
+    RoutingServer(std::shared_ptr<RoutingGraph> graph, Options options)
+            : graph(std::move(graph)), options(std::move(options)) {}
+
+    RoutingServer(const RoutingServer &) = delete;
+    RoutingServer &operator=(const RoutingServer &) = delete;
+
+    // Bloquea hasta que se llame a 'stop'. Devuelve falso si no se pudo abrir el socket
+    bool serve() {
+        if (!open_listener()) return false;
+        if (pipe(wake_pipe) != 0) return false;
+        set_nonblocking(wake_pipe[0]);
+        set_nonblocking(wake_pipe[1]);
+
+        for (unsigned i = 0; i < std::max(1u, options.workers); ++i) {
+            workers.emplace_back([this] { work(); });
+        }
+
+        std::vector<pollfd> fds;
+        std::vector<std::uint64_t> polled;
+        while (!stopping.load()) {
+            fds.clear();
+            polled.clear();
+            fds.push_back({listener, POLLIN, 0});
+            fds.push_back({wake_pipe[0], POLLIN, 0});
+            for (auto &[id, connection] : connections) {
+                short events = 0;
+                if (connection.held.size() < options.max_output &&
+                    connection.out.size() - connection.sent < options.max_output) {
+                    events |= POLLIN;
+                }
+                if (connection.sent < connection.out.size()) events |= POLLOUT;
+                fds.push_back({connection.fd, events, 0});
+                polled.push_back(id);
+            }
+
+            if (poll(fds.data(), fds.size(), 100) < 0 && errno != EINTR) break;
+
+            if (fds[0].revents & POLLIN) accept_connections();
+            if (fds[1].revents & POLLIN) deliver_replies();
+
+            std::vector<std::shared_ptr<RoutingJob>> batch;
+            for (auto &[id, connection] : connections) release_held(connection, batch);
+            for (std::size_t i = 0; i < polled.size(); ++i) {
+                auto it = connections.find(polled[i]);
+                if (it == connections.end()) continue;
+                Connection &connection = it->second;
+                short revents = fds[i + 2].revents;
+
+                bool alive = true;
+                if (revents & POLLIN) alive = read_requests(connection, batch);
+                if (alive && (revents & POLLOUT)) alive = flush(connection);
+                if (revents & (POLLERR | POLLNVAL)) alive = false;
+                if (revents & POLLHUP && !(revents & POLLIN)) alive = false;
+                if (!alive) close_connection(it->first);
+            }
+            enqueue(batch);
+        }
+
+        shutdown();
+        return true;
+    }
+
+    // Se puede llamar desde otro hilo o desde un manejador de senales
+    void stop() {
+        stopping.store(true);
+        if (wake_pipe[1] >= 0) {
+            char byte = 0;
+            (void) !write(wake_pipe[1], &byte, 1);
+        }
+    }
+
+private:
+    struct Connection {
+        std::uint64_t id = 0;
+        int fd = -1;
+        std::vector<std::uint8_t> in;
+        std::vector<std::uint8_t> out;
+        std::size_t sent = 0;
+        std::vector<std::uint8_t> held;     // Frames de pedidos nuevos que llegaron con la cola llena
+        std::unordered_set<std::uint32_t> pending;
+    };
+
+    std::shared_ptr<RoutingGraph> graph;
+    Options options;
+
+    int listener = -1;
+    int wake_pipe[2] = {-1, -1};
+    std::atomic<bool> stopping{false};
+
+    std::unordered_map<std::uint64_t, Connection> connections;
+    std::uint64_t next_connection = 1;
+    std::unordered_map<std::uint64_t, std::shared_ptr<RoutingJob>> in_flight;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<std::shared_ptr<RoutingJob>> queue;
+    std::atomic<std::size_t> queued{0};
+    std::vector<std::thread> workers;
+
+    std::mutex replies_mutex;
+    std::vector<RoutingReply> replies;
+
+    std::thread reloader;
+    std::atomic<bool> reloading{false};
+
+    static std::uint64_t job_key(std::uint64_t connection, std::uint32_t id) {
+        return (connection << 32u) | id;
+    }
+
+    static void set_nonblocking(int fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    static std::vector<std::uint8_t> reply_frame(std::uint32_t id, Status status) {
+        ByteWriter writer;
+        writer.put(id);
+        writer.put(static_cast<std::uint8_t>(status));
+        return writer.finish();
+    }
+
+    bool open_listener() {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options.socket_path.size() >= sizeof(address.sun_path)) return false;
+        std::strncpy(address.sun_path, options.socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) return false;
+        unlink(options.socket_path.c_str());
+        if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            listen(listener, 128) != 0) {
+            close(listener);
+            listener = -1;
+            return false;
+        }
+        set_nonblocking(listener);
+        return true;
+    }
+
+    void accept_connections() {
+        while (true) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd < 0) return;
+            set_nonblocking(fd);
+            Connection &connection = connections[next_connection];
+            connection.id = next_connection++;
+            connection.fd = fd;
+        }
+    }
+
+    void close_connection(std::uint64_t id) {
+        Connection &connection = connections[id];
+        for (std::uint32_t request : connection.pending) {
+            auto it = in_flight.find(job_key(id, request));
+            if (it == in_flight.end()) continue;
+            it->second->cancelled.store(true);
+            in_flight.erase(it);
+        }
+        close(connection.fd);
+        connections.erase(id);
+    }
+
+    void send(Connection &connection, const std::vector<std::uint8_t> &frame) {
+        connection.out.insert(connection.out.end(), frame.begin(), frame.end());
+    }
+
+    // Escribe lo que el socket acepte sin bloquear; devuelve falso si la conexion se rompio
+    bool flush(Connection &connection) {
+        while (connection.sent < connection.out.size()) {
+            ssize_t n = ::send(connection.fd, connection.out.data() + connection.sent,
+                               connection.out.size() - connection.sent, 0);
+            if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            connection.sent += static_cast<std::size_t>(n);
+        }
+        connection.out.clear();
+        connection.sent = 0;
+        return true;
+    }
+
+    bool read_requests(Connection &connection, std::vector<std::shared_ptr<RoutingJob>> &batch) {
+        std::uint8_t buffer[64 * 1024];
+        while (true) {
+            ssize_t n = recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (n == 0) return false;
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                if (errno == EINTR) continue;
+                return false;
+            }
+            connection.in.insert(connection.in.end(), buffer, buffer + n);
+        }
+
+        std::size_t offset = 0;
+        while (connection.in.size() - offset >= sizeof(std::uint32_t)) {
+            std::uint32_t length;
+            std::memcpy(&length, connection.in.data() + offset, sizeof(length));
+            if (length > max_frame_length) return false;
+            if (connection.in.size() - offset - sizeof(length) < length) break;
+
+            const std::uint8_t *frame = connection.in.data() + offset;
+            offset += sizeof(length) + length;
+            if (is_control(frame + sizeof(length), length) || !must_hold(connection, batch)) {
+                ByteReader reader(frame + sizeof(length), length);
+                handle_frame(connection, reader, batch);
+            } else {
+                connection.held.insert(connection.held.end(), frame, frame + sizeof(length) + length);
+            }
+        }
+        connection.in.erase(connection.in.begin(), connection.in.begin() + static_cast<std::ptrdiff_t>(offset));
+        return flush(connection);
+    }
+
+    // 'Cancel' y 'Reload' no ocupan lugar en la cola, se atienden aunque haya backpressure
+    static bool is_control(const std::uint8_t *body, std::uint32_t length) {
+        if (length <= sizeof(std::uint32_t)) return false;
+        auto type = static_cast<RequestType>(body[sizeof(std::uint32_t)]);
+        return type == RequestType::Cancel || type == RequestType::Reload;
+    }
+
+    // Un pedido nuevo espera si la cola esta llena o si ya hay otros retenidos antes que el (se respeta el orden)
+    bool must_hold(const Connection &connection, const std::vector<std::shared_ptr<RoutingJob>> &batch) const {
+        return !connection.held.empty() || queued.load() + batch.size() >= options.queue_capacity;
+    }
+
+    // Encola los frames retenidos de 'connection' mientras haya lugar en la cola
+    void release_held(Connection &connection, std::vector<std::shared_ptr<RoutingJob>> &batch) {
+        std::size_t offset = 0;
+        while (offset < connection.held.size() && queued.load() + batch.size() < options.queue_capacity) {
+            std::uint32_t length;
+            std::memcpy(&length, connection.held.data() + offset, sizeof(length));
+            ByteReader reader(connection.held.data() + offset + sizeof(length), length);
+            offset += sizeof(length) + length;
+            handle_frame(connection, reader, batch);
+        }
+        connection.held.erase(connection.held.begin(), connection.held.begin() + static_cast<std::ptrdiff_t>(offset));
+    }
+
+    // Quita de 'held' el pedido 'id', si todavia no se encolo
+    static bool drop_held(Connection &connection, std::uint32_t id) {
+        for (std::size_t offset = 0; offset < connection.held.size(); ) {
+            std::uint32_t length, frame_id = 0;
+            std::memcpy(&length, connection.held.data() + offset, sizeof(length));
+            if (length >= sizeof(frame_id)) {
+                std::memcpy(&frame_id, connection.held.data() + offset + sizeof(length), sizeof(frame_id));
+            }
+            auto first = connection.held.begin() + static_cast<std::ptrdiff_t>(offset);
+            if (length >= sizeof(frame_id) && frame_id == id) {
+                connection.held.erase(first, first + static_cast<std::ptrdiff_t>(sizeof(length) + length));
+                return true;
+            }
+            offset += sizeof(length) + length;
+        }
+        return false;
+    }
+
+    void handle_frame(Connection &connection, ByteReader &reader, std::vector<std::shared_ptr<RoutingJob>> &batch) {
+        std::uint64_t connection_id = connection.id;
+        auto id = reader.get<std::uint32_t>();
+        auto type = static_cast<RequestType>(reader.get<std::uint8_t>());
+        if (!reader.ok) return send(connection, reply_frame(id, Status::BadRequest));
+
+        if (type == RequestType::Cancel) {
+            auto target = reader.get<std::uint32_t>();
+            if (!reader.ok) return send(connection, reply_frame(id, Status::BadRequest));
+            auto it = in_flight.find(job_key(connection_id, target));
+            if (it != in_flight.end()) {
+                it->second->cancelled.store(true);
+            } else if (drop_held(connection, target)) {
+                send(connection, reply_frame(target, Status::Cancelled));
+            } else {
+                return send(connection, reply_frame(id, Status::NotFound));
+            }
+            return send(connection, reply_frame(id, Status::Ok));
+        }
+
+        if (type == RequestType::Reload) {
+            std::string nodes_path = reader.get_string();
+            std::string edges_path = reader.get_string();
+            if (!reader.ok) return send(connection, reply_frame(id, Status::BadRequest));
+            if (!start_reload(connection_id, id, nodes_path, edges_path)) {
+                return send(connection, reply_frame(id, Status::Overloaded));
+            }
+            return;
+        }
+
+        auto job = std::make_shared<RoutingJob>();
+        job->connection = connection_id;
+        job->id = id;
+        job->type = type;
+        auto deadline_ms = reader.get<std::uint32_t>();
+        if (deadline_ms > 0) job->deadline = RoutingClock::now() + std::chrono::milliseconds(deadline_ms);
+
+        switch (type) {
+            case RequestType::Route:
+                job->sources.push_back(reader.get<std::uint64_t>());
+                job->targets.push_back(reader.get<std::uint64_t>());
+                break;
+            case RequestType::Matrix: {
+                auto n = reader.get<std::uint32_t>();
+                auto m = reader.get<std::uint32_t>();
+                if (!reader.ok || static_cast<std::uint64_t>(n) * m > options.max_matrix_cells ||
+                    reader.remaining() != (static_cast<std::size_t>(n) + m) * sizeof(std::uint64_t)) {
+                    return send(connection, reply_frame(id, Status::BadRequest));
+                }
+                for (std::uint32_t i = 0; i < n; ++i) job->sources.push_back(reader.get<std::uint64_t>());
+                for (std::uint32_t j = 0; j < m; ++j) job->targets.push_back(reader.get<std::uint64_t>());
+                break;
+            }
+            case RequestType::Nearest:
+                job->x = reader.get<float>();
+                job->y = reader.get<float>();
+                break;
+            default:
+                return send(connection, reply_frame(id, Status::BadRequest));
+        }
+        if (!reader.ok) return send(connection, reply_frame(id, Status::BadRequest));
+
+        // Un id que ya esta en vuelo en esta conexion es un error del cliente, no falta de capacidad
+        if (in_flight.count(job_key(connection_id, id))) return send(connection, reply_frame(id, Status::BadRequest));
+        if (queued.load() + batch.size() >= 2 * options.queue_capacity) {
+            return send(connection, reply_frame(id, Status::Overloaded));
+        }
+        in_flight[job_key(connection_id, id)] = job;
+        connection.pending.insert(id);
+        batch.push_back(std::move(job));
+    }
+
+    void enqueue(std::vector<std::shared_ptr<RoutingJob>> &batch) {
+        if (batch.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            for (auto &job : batch) queue.push_back(std::move(job));
+            queued.store(queue.size());
+        }
+        if (batch.size() == 1) {
+            queue_cv.notify_one();
+        } else {
+            queue_cv.notify_all();
+        }
+    }
+
+    void post(RoutingReply &&reply) {
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> lock(replies_mutex);
+            was_empty = replies.empty();
+            replies.push_back(std::move(reply));
+        }
+        // Si ya habia respuestas sin entregar, el hilo de I/O ya fue despertado y se llevara esta tambien
+        if (!was_empty) return;
+        char byte = 1;
+        (void) !write(wake_pipe[1], &byte, 1);
+    }
+
+    void deliver_replies() {
+        char drain[256];
+        while (read(wake_pipe[0], drain, sizeof(drain)) > 0) {}
+
+        std::vector<RoutingReply> ready;
+        {
+            std::lock_guard<std::mutex> lock(replies_mutex);
+            ready.swap(replies);
+        }
+        std::vector<std::uint64_t> broken;
+        for (RoutingReply &reply : ready) {
+            in_flight.erase(job_key(reply.connection, reply.id));
+            auto it = connections.find(reply.connection);
+            if (it == connections.end()) continue; // El cliente ya se fue
+            it->second.pending.erase(reply.id);
+            send(it->second, reply.frame);
+        }
+        for (auto &[id, connection] : connections) {
+            if (!flush(connection)) broken.push_back(id);
+        }
+        for (std::uint64_t id : broken) close_connection(id);
+    }
+
+    void work() {
+        std::size_t pool = std::max(1u, options.workers);
+        std::vector<std::shared_ptr<RoutingJob>> taken;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_cv.wait(lock, [&] { return stopping.load() || !queue.empty(); });
+                if (stopping.load()) return;
+                std::size_t share = std::min(std::max<std::size_t>(1, options.max_batch),
+                                             (queue.size() + pool - 1) / pool);
+                while (!queue.empty() && taken.size() < share) {
+                    taken.push_back(std::move(queue.front()));
+                    queue.pop_front();
+                }
+                queued.store(queue.size());
+            }
+
+            // Todo el lote usa la misma version del grafo
+            std::shared_ptr<RoutingGraph> snapshot = std::atomic_load(&graph);
+            for (auto &job : taken) {
+                post({job->connection, job->id, answer(*job, *snapshot)});
+            }
+            taken.clear();
+        }
+    }
+
+    std::vector<std::uint8_t> answer(RoutingJob &job, RoutingGraph &routing) const {
+        if (job.cancelled.load()) return reply_frame(job.id, Status::Cancelled);
+        if (RoutingClock::now() > job.deadline) return reply_frame(job.id, Status::DeadlineExceeded);
+
+        bool interrupted = false;
+        auto interrupt_status = [&] {
+            return job.cancelled.load() ? Status::Cancelled : Status::DeadlineExceeded;
+        };
+
+        ByteWriter writer;
+        writer.put(job.id);
+        switch (job.type) {
+            case RequestType::Route: {
+                Node *src = routing.find(job.sources[0]);
+                Node *dest = routing.find(job.targets[0]);
+                if (src == nullptr || dest == nullptr) return reply_frame(job.id, Status::NotFound);
+
+                using Stop = Interruptible<StopAtTarget>;
+                SearchEngine<LengthWeight, ZeroHeuristic, MinHeapQueue, Stop> engine(
+                        NullVisitor(), LengthWeight(), ZeroHeuristic(),
+                        Stop{StopAtTarget(), &job.cancelled, job.deadline, &interrupted});
+                auto result = engine.run(src, dest);
+                if (interrupted) return reply_frame(job.id, interrupt_status());
+
+                std::vector<std::uint64_t> ids;
+                auto found = result.dist.find(dest);
+                if (found != result.dist.end()) {
+                    for (Node *current = dest; ; current = result.parent[current]) {
+                        ids.push_back(current->id);
+                        if (current == src) break;
+                    }
+                    std::reverse(ids.begin(), ids.end());
+                }
+                writer.put(static_cast<std::uint8_t>(Status::Ok));
+                writer.put(found == result.dist.end() ? static_cast<double>(INFINITY) : found->second);
+                writer.put(static_cast<std::uint32_t>(ids.size()));
+                for (std::uint64_t node : ids) writer.put(node);
+                break;
+            }
+            case RequestType::Matrix: {
+                std::vector<Node *> targets;
+                for (std::size_t id : job.targets) {
+                    targets.push_back(routing.find(id));
+                    if (targets.back() == nullptr) return reply_frame(job.id, Status::NotFound);
+                }
+                std::vector<double> cells;
+                cells.reserve(job.sources.size() * targets.size());
+                for (std::size_t id : job.sources) {
+                    // Cada fila arranca un 'Interruptible' nuevo con su contador en 0, asi que entre filas hay que
+                    // revisar a mano; si no, una matriz de filas cortas nunca llega a consultar el reloj
+                    if (job.cancelled.load() || RoutingClock::now() > job.deadline) {
+                        return reply_frame(job.id, interrupt_status());
+                    }
+                    Node *src = routing.find(id);
+                    if (src == nullptr) return reply_frame(job.id, Status::NotFound);
+
+                    using Stop = Interruptible<StopAtAll<Node *>>;
+                    SearchEngine<LengthWeight, ZeroHeuristic, MinHeapQueue, Stop> engine(
+                            NullVisitor(), LengthWeight(), ZeroHeuristic(),
+                            Stop{StopAtAll<Node *>(targets), &job.cancelled, job.deadline, &interrupted});
+                    auto result = engine.run(src, nullptr);
+                    if (interrupted) return reply_frame(job.id, interrupt_status());
+
+                    for (Node *target : targets) {
+                        auto it = result.dist.find(target);
+                        cells.push_back(it == result.dist.end() ? static_cast<double>(INFINITY) : it->second);
+                    }
+                }
+                writer.put(static_cast<std::uint8_t>(Status::Ok));
+                writer.put(static_cast<std::uint32_t>(job.sources.size()));
+                writer.put(static_cast<std::uint32_t>(targets.size()));
+                for (double d : cells) writer.put(d);
+                break;
+            }
+            case RequestType::Nearest: {
+                double distance;
+                Node *node = routing.nearest(job.x, job.y, distance);
+                if (node == nullptr) return reply_frame(job.id, Status::NotFound);
+                writer.put(static_cast<std::uint8_t>(Status::Ok));
+                writer.put(static_cast<std::uint64_t>(node->id));
+                writer.put(distance);
+                break;
+            }
+            default:
+                return reply_frame(job.id, Status::BadRequest);
+        }
+        return writer.finish();
+    }
+
+    bool start_reload(std::uint64_t connection, std::uint32_t id, std::string nodes_path, std::string edges_path) {
+        if (reloading.exchange(true)) return false;
+        if (reloader.joinable()) reloader.join();
+
+        std::shared_ptr<RoutingGraph> current = std::atomic_load(&graph);
+        if (nodes_path.empty()) nodes_path = current->nodes_path;
+        if (edges_path.empty()) edges_path = current->edges_path;
+
+        reloader = std::thread([this, connection, id, nodes_path, edges_path] {
+            auto fresh = std::make_shared<RoutingGraph>(nodes_path, edges_path);
+            RoutingReply reply{connection, id, reply_frame(id, Status::BadRequest)};
+            if (!fresh->graph.nodes.empty()) {
+                ByteWriter writer;
+                writer.put(id);
+                writer.put(static_cast<std::uint8_t>(Status::Ok));
+                writer.put(static_cast<std::uint64_t>(fresh->graph.nodes.size()));
+                writer.put(static_cast<std::uint64_t>(fresh->graph.edges.size()));
+                std::atomic_store(&graph, std::move(fresh));
+                reply.frame = writer.finish();
+            }
+            reloading.store(false);
+            post(std::move(reply));
+        });
+        return true;
+    }
+
+    void shutdown() {
+        stopping.store(true);
+        queue_cv.notify_all();
+        for (std::thread &worker : workers) worker.join();
+        workers.clear();
+        if (reloader.joinable()) reloader.join();
+
+        std::vector<std::uint64_t> open;
+        for (auto &[id, _] : connections) open.push_back(id);
+        for (std::uint64_t id : open) close_connection(id);
+
+        close(listener);
+        unlink(options.socket_path.c_str());
+        close(wake_pipe[0]);
+        close(wake_pipe[1]);
+        listener = wake_pipe[0] = wake_pipe[1] = -1;
+    }
+};
+
+
+#endif //HOMEWORK_GRAPH_ROUTING_SERVER_H
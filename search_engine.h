@@ -0,0 +1,322 @@
+#ifndef HOMEWORK_GRAPH_SEARCH_ENGINE_H
+#define HOMEWORK_GRAPH_SEARCH_ENGINE_H
+
+
+#include "graph.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <vector>
+#include <cmath>
+
+
+// *
+// ---- SearchEngine ----
+// Motor de busqueda generico. Dijkstra, BFS y A* son el mismo bucle: sacar un vertice de la frontera,
+// recorrer sus aristas y relajar a sus vecinos. Lo unico que cambia entre ellos es:
+//
+//     - Weight        : Costo de recorrer una arista            (LengthWeight, HopWeight)
+//     - Heuristic     : Estimado del costo restante al destino  (ZeroHeuristic, EuclideanHeuristic)
+//     - Queue         : Orden en que se procesa la frontera     (MinHeapQueue, FifoQueue)
+//     - Stop          : Cuando se termina la busqueda           (StopAtTarget, StopAtAll, ExhaustiveSearch)
+//     - Visitor       : Hooks de visualizacion / instrumentacion (NullVisitor)
+//     - Topology      : Como se enumeran las aristas de un vertice (PointerTopology)
+//
+// Todas las politicas se resuelven en tiempo de compilacion, de modo que no hay llamadas virtuales dentro
+// del bucle y, con 'NullVisitor', los hooks desaparecen por completo en el binario.
+// *
+
+
+// *
+// ---- PointerTopology ----
+// Recorre el grafo tal como lo construye 'Graph::parse_csv': vertices 'Node*' y aristas en 'Node::edges'.
+// Una arista de doble sentido aparece en la lista de ambos extremos, por eso el vecino es el extremo opuesto a 'u'.
+// *
+struct PointerTopology {
+    using node_type = Node *;
+    using edge_type = Edge;
+
+    template <typename T>
+    using node_map = std::unordered_map<Node *, T>;
+
+    template <typename Visit>
+    void for_each_edge(Node *u, Visit &&visit) const {
+        for (Edge *e : u->edges) {
+            visit(*e, (e->src == u) ? e->dest : e->src);
+        }
+    }
+
+    sf::Vector2f coord(Node *u) const {
+        return u->coord;
+    }
+};
+
+
+// *
+// ---- DenseNodeMap ----
+// Alternativa a std::unordered_map para topologias con vertices enteros y densos (0 .. n - 1). Tiene la misma
+// interfaz que usa 'SearchEngine' (find / end / operator[]) pero guarda las etiquetas en un vector que crece
+// a demanda. Conviene para busquedas que recorren gran parte del grafo.
+// *
+template <typename T>
+class DenseNodeMap {
+    static constexpr std::uint32_t absent = ~std::uint32_t{0};
+    std::vector<std::pair<std::uint32_t, T>> slots;
+
+public:
+    using iterator = std::pair<std::uint32_t, T> *;
+
+    iterator find(std::uint32_t v) {
+        return (v < slots.size() && slots[v].first == v) ? &slots[v] : end();
+    }
+
+    iterator end() {
+        return nullptr;
+    }
+
+    T &operator[](std::uint32_t v) {
+        if (v >= slots.size()) slots.resize(std::max<std::size_t>(v + 1, 2 * slots.size()), {absent, T()});
+        slots[v].first = v;
+        return slots[v].second;
+    }
+
+    std::size_t capacity() const {
+        return slots.size();
+    }
+};
+
+
+// ---- Politicas de peso ----
+
+// Peso = longitud de la arista (Dijkstra, A*). Sirve para cualquier arista con miembro 'length'
+struct LengthWeight {
+    template <typename EdgeT>
+    double operator()(const EdgeT &e) const {
+        return e.length;
+    }
+};
+
+// Peso = 1 por arista, cuenta saltos (BFS)
+struct HopWeight {
+    template <typename EdgeT>
+    double operator()(const EdgeT &) const {
+        return 1.0;
+    }
+};
+
+
+// ---- Politicas de heuristica ----
+
+struct ZeroHeuristic {
+    template <typename Topology, typename NodeT>
+    double operator()(const Topology &, NodeT, NodeT) const {
+        return 0.0;
+    }
+};
+
+// Distancia en linea recta entre 'v' y 'target', admisible si las longitudes estan en las mismas unidades que 'coord'
+struct EuclideanHeuristic {
+    template <typename Topology, typename NodeT>
+    double operator()(const Topology &topology, NodeT v, NodeT target) const {
+        sf::Vector2f a = topology.coord(v);
+        sf::Vector2f b = topology.coord(target);
+        float dx = a.x - b.x;
+        float dy = a.y - b.y;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+};
+
+
+// ---- Politicas de parada ----
+
+// Termina en cuanto se asienta el destino
+struct StopAtTarget {
+    template <typename NodeT>
+    bool operator()(NodeT settled, NodeT target) const {
+        return settled == target;
+    }
+};
+
+// Nunca termina antes de vaciar la frontera (one-to-all)
+struct ExhaustiveSearch {
+    template <typename NodeT>
+    bool operator()(NodeT, NodeT) const {
+        return false;
+    }
+};
+
+
+// Termina cuando se asentaron todos los vertices de 'targets' (one-to-many, p. ej. una fila de una matriz de distancias)
+template <typename NodeT>
+struct StopAtAll {
+    std::unordered_set<NodeT> pending;
+
+    explicit StopAtAll(const std::vector<NodeT> &targets = {}) : pending(targets.begin(), targets.end()) {}
+
+    bool operator()(NodeT settled, NodeT) {
+        pending.erase(settled);
+        return pending.empty();
+    }
+};
+
+
+// ---- Visitantes ----
+
+// No hace nada, el compilador elimina las llamadas
+struct NullVisitor {
+    template <typename NodeT>
+    void on_settle(NodeT) {}
+
+    template <typename NodeT>
+    void on_relax(NodeT, NodeT) {}
+};
+
+
+// ---- Colas ----
+// 'key' es la prioridad (g + h) y 'g' la distancia con la que se inserto, usada para descartar entradas obsoletas.
+
+template <typename NodeT>
+struct QueueEntry {
+    NodeT node;
+    double key;
+    double g;
+
+    bool operator > (const QueueEntry &other) const {
+        return key > other.key;
+    }
+};
+
+template <typename NodeT>
+class MinHeapQueue {
+    std::priority_queue<QueueEntry<NodeT>, std::vector<QueueEntry<NodeT>>, std::greater<>> heap;
+
+public:
+    void push(const QueueEntry<NodeT> &entry) {
+        heap.push(entry);
+    }
+
+    QueueEntry<NodeT> pop() {
+        QueueEntry<NodeT> top = heap.top();
+        heap.pop();
+        return top;
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+};
+
+template <typename NodeT>
+class FifoQueue {
+    std::queue<QueueEntry<NodeT>> fifo;
+
+public:
+    void push(const QueueEntry<NodeT> &entry) {
+        fifo.push(entry);
+    }
+
+    QueueEntry<NodeT> pop() {
+        QueueEntry<NodeT> front = fifo.front();
+        fifo.pop();
+        return front;
+    }
+
+    bool empty() const {
+        return fifo.empty();
+    }
+};
+
+
+template <typename Weight,
+          typename Heuristic,
+          template <typename> class Queue,
+          typename Stop,
+          typename Visitor = NullVisitor,
+          typename Topology = PointerTopology>
+class SearchEngine {
+public:
+    using node_type = typename Topology::node_type;
+
+    template <typename T>
+    using node_map = typename Topology::template node_map<T>;
+
+    //* --- Result ---
+    //     - dist          : Distancia final de cada vertice alcanzado
+    //     - parent        : Vertice anterior en el camino mas corto, se usa para reconstruir el 'path'
+    //     - settled       : Cantidad de vertices extraidos de la frontera
+    //     - relaxed       : Cantidad de relajaciones exitosas
+    //*
+    struct Result {
+        node_map<double> dist;
+        node_map<node_type> parent;
+        std::size_t settled = 0;
+        std::size_t relaxed = 0;
+    };
+
+    explicit SearchEngine(Visitor visitor = Visitor(),
+                          Weight weight = Weight(),
+                          Heuristic heuristic = Heuristic(),
+                          Stop stop = Stop(),
+                          Topology topology = Topology())
+            : visitor(visitor), weight(weight), heuristic(heuristic), stop(stop), topology(topology) {}
+
+    Result run(node_type src, node_type target) {
+        Result result;
+        Queue<node_type> open;
+
+        result.dist[src] = 0.0;
+        open.push({src, heuristic(topology, src, target), 0.0});
+
+        while (!open.empty()) {
+            QueueEntry<node_type> entry = open.pop();
+            node_type u = entry.node;
+            if (entry.g > result.dist[u]) continue; // Entrada obsoleta, 'u' ya se asento con menor distancia
+
+            ++result.settled;
+            visitor.on_settle(u);
+            if (stop(u, target)) break;
+
+            topology.for_each_edge(u, [&](const auto &e, node_type v) {
+                double candidate = entry.g + weight(e);
+                auto it = result.dist.find(v);
+                if (it != result.dist.end() && candidate >= it->second) return;
+
+                result.dist[v] = candidate;
+                result.parent[v] = u;
+                ++result.relaxed;
+                open.push({v, candidate + heuristic(topology, v, target), candidate});
+                visitor.on_relax(u, v);
+            });
+        }
+
+        return result;
+    }
+
+private:
+    Visitor visitor;
+    Weight weight;
+    Heuristic heuristic;
+    Stop stop;
+    Topology topology;
+};
+
+
+// ---- Instancias ----
+
+template <typename Visitor = NullVisitor>
+using DijkstraSearch = SearchEngine<LengthWeight, ZeroHeuristic, MinHeapQueue, StopAtTarget, Visitor>;
+
+template <typename Visitor = NullVisitor>
+using BFSSearch = SearchEngine<HopWeight, ZeroHeuristic, FifoQueue, StopAtTarget, Visitor>;
+
+template <typename Visitor = NullVisitor>
+using AStarSearch = SearchEngine<LengthWeight, EuclideanHeuristic, MinHeapQueue, StopAtTarget, Visitor>;
+
+template <typename Visitor = NullVisitor>
+using OneToAllDijkstra = SearchEngine<LengthWeight, ZeroHeuristic, MinHeapQueue, ExhaustiveSearch, Visitor>;
+
+
+#endif //HOMEWORK_GRAPH_SEARCH_ENGINE_H